@@ -13,42 +13,326 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
+#include <unistd.h>
 #include "assert.h"
 #include "compress40.h"
+#include "codecModes.h"
+#include "parallelCodec.h"
+#include "pipelineCodec.h"
+#include "batchCodec.h"
+#include "sharedScheduler.h"
+
+/* The modes 40image can run in; every mode produces the same output */
+enum codecMode { STAGED, FUSED, STREAM, PARALLEL, PIPELINE };
+
+/* The number of threads given with -j */
+static unsigned threads = 1;
+
+/* The ring depth given with -q, and whether -v asked for pipeline stats */
+static unsigned queueDepth = 4;
+static bool verbose = false;
+
+/* Whether -F lets a batch replace outputs that already exist */
+static bool overwrite = false;
+
+static void usage(char *program);
+static unsigned parseThreads(char *program, char *arg);
+static unsigned onlineProcessors(void);
+static void compressParallel(FILE *input);
+static void decompressParallel(FILE *input);
+static void compressPipelined(FILE *input);
+static void decompressPipelined(FILE *input);
+static void reportPipeline(struct pipelineStats stats);
+static int runBatch(char *program, char *manifest, char **paths, 
+                    unsigned count, bool compressing, unsigned workers);
+
+/* The compress and decompress functions used by each mode */
+static const struct {
+        void (*compress)(FILE *input);
+        void (*decompress)(FILE *input);
+} modes[] = {
+        [STAGED] = { compress40, decompress40 },
+        [FUSED] = { compress40Fused, decompress40Fused },
+        [STREAM] = { compress40Stream, decompress40Stream },
+        [PARALLEL] = { compressParallel, decompressParallel },
+        [PIPELINE] = { compressPipelined, decompressPipelined },
+};
 
 static void (*compress_or_decompress)(FILE *input) = compress40;
 
 int main(int argc, char *argv[])
 {
         int i;
+        bool compressing = true;
+        bool fused = false, stream = false, pipelined = false;
+        bool threadsGiven = false, queueGiven = false;
+        bool batch = false;
+        char *manifest = NULL;
         
         for (i = 1; i < argc; i++) {
                 if (strcmp(argv[i], "-c") == 0) {
-                        compress_or_decompress = compress40;
+                        compressing = true;
                 } else if (strcmp(argv[i], "-d") == 0) {
-                        compress_or_decompress = decompress40;
+                        compressing = false;
+                } else if (strcmp(argv[i], "-f") == 0) {
+                        fused = true;
+                } else if (strcmp(argv[i], "-s") == 0) {
+                        stream = true;
+                } else if (strcmp(argv[i], "-p") == 0) {
+                        pipelined = true;
+                } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+                        threadsGiven = true;
+                        threads = parseThreads(argv[0], argv[++i]);
+                } else if (strcmp(argv[i], "-q") == 0 && i + 1 < argc) {
+                        queueGiven = true;
+                        queueDepth = parseThreads(argv[0], argv[++i]);
+                } else if (strcmp(argv[i], "-v") == 0) {
+                        verbose = true;
+                } else if (strcmp(argv[i], "-b") == 0) {
+                        batch = true;
+                } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+                        manifest = argv[++i];
+                } else if (strcmp(argv[i], "-F") == 0) {
+                        overwrite = true;
                 } else if (*argv[i] == '-') {
-                        fprintf(stderr, "%s: unknown option '%s'\n",
+                        fprintf(stderr, "%s: unknown option '%s'\n", 
                                 argv[0], argv[i]);
-                        exit(1);
-                } else if (argc - i > 2) {
-                        fprintf(stderr, "Usage: %s -d [filename]\n"
-                                "       %s -c [filename]\n",
-                                argv[0], argv[0]);
-                        exit(1);
+                        usage(argv[0]);
                 } else {
                         break;
                 }
         }
-        assert(argc - i <= 1);    /* at most one file on command line */
-        if (i < argc) {
-                FILE *fp = fopen(argv[i], "r");
-                assert(fp != NULL);
-                compress_or_decompress(fp);
-                fclose(fp);
+
+        /* -f, -s, and -p each choose a mode, and -j chooses one of its own
+           unless it is sizing -p. -q and -v only mean something to -p, 
+           and -F only to a batch, which runs in a mode of its own. A flag
+           that would be ignored or would override another is an error */
+        bool batched = batch || manifest != NULL;
+        unsigned chosen = fused + stream + pipelined;
+        if (chosen > 1 || (threadsGiven && (fused || stream)) || 
+            ((queueGiven || verbose) && !pipelined) || 
+            (batched && chosen > 0) || (overwrite && !batched)) {
+                fprintf(stderr, "%s: conflicting options\n", argv[0]);
+                usage(argv[0]);
+        }
+        enum codecMode mode = fused ? FUSED 
+                            : stream ? STREAM 
+                            : pipelined ? PIPELINE 
+                            : threadsGiven ? PARALLEL 
+                            : STAGED;
+
+        compress_or_decompress = compressing ? modes[mode].compress 
+                                             : modes[mode].decompress;
+        bool threaded = (mode == PARALLEL || mode == PIPELINE);
+        unsigned workers = threaded ? threads : onlineProcessors();
+
+        /* The stages of the default codec run their rows on the shared 
+           scheduler, which may use no more threads than -j gave */
+        SharedScheduler_limit(threads);
+
+        /* In batch mode every file gets its own output file */
+        if (batched) {
+                return runBatch(argv[0], manifest, &argv[i], argc - i, 
+                                compressing, workers);
+        }
+
+        /* Several files share one pool of workers instead of running 
+           one after another, unless -f, -s, or -p chose a mode of its 
+           own, which then converts each file in turn */
+        bool shared = (mode == STAGED || mode == PARALLEL);
+        if (argc - i > 1 && shared) {
+                if (compressing) {
+                        compress40Files(&argv[i], argc - i, workers);
+                } else {
+                        decompress40Files(&argv[i], argc - i, workers);
+                }
+        } else if (i < argc) {
+                for (; i < argc; i++) {
+                        FILE *fp = fopen(argv[i], "r");
+                        assert(fp != NULL);
+                        compress_or_decompress(fp);
+                        fclose(fp);
+                }
         } else {
                 compress_or_decompress(stdin);
         }
 
         return EXIT_SUCCESS; 
 }
+
+/********** usage ********
+ *
+ * Prints how 40image may be run and exits
+ *
+ * Parameters:
+ *      char *program: the name 40image was run as
+ *
+ * Return: 
+ *      none; exits with status 1
+ *
+ ************************/
+static void usage(char *program)
+{
+        fprintf(stderr, 
+                "Usage: %s -d [-f | -s | -j N | -p [-j N] "
+                "[-q DEPTH] [-v]] [filename...]\n"
+                "       %s -c [-f | -s | -j N | -p [-j N] "
+                "[-q DEPTH] [-v]] [filename...]\n"
+                "       %s -c | -d [-j N] [-F] -b filename...\n"
+                "       %s -c | -d [-j N] [-F] -m manifest\n",
+                program, program, program, program);
+        exit(1);
+}
+
+/********** parseThreads ********
+ *
+ * Parses the count given with -j or -q, exiting with a message if it is
+ * not a positive number
+ *
+ * Parameters:
+ *      char *program: the name 40image was run as
+ *      char *arg:     the argument after -j or -q
+ *
+ * Return: 
+ *      the count
+ *
+ ************************/
+static unsigned parseThreads(char *program, char *arg)
+{
+        char *end;
+        long count = strtol(arg, &end, 10);
+        if (*arg == '\0' || *end != '\0' || count < 1 || count > 4096) {
+                fprintf(stderr, "%s: bad thread count '%s'\n", program, arg);
+                exit(1);
+        }
+        return count;
+}
+
+/********** onlineProcessors ********
+ *
+ * Returns the number of processors available, to size the pool of workers
+ * when several files are given without -j
+ *
+ ************************/
+static unsigned onlineProcessors(void)
+{
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        return (count < 1) ? 1 : count;
+}
+
+/********** runBatch ********
+ *
+ * Converts the files named on the command line, or in a manifest, each to
+ * its own output file
+ *
+ * Parameters:
+ *      char *program:    the name 40image was run as
+ *      char *manifest:   the name of the manifest, or NULL to use paths
+ *      char **paths:     the files named on the command line
+ *      unsigned count:   the number of paths
+ *      bool compressing: true to compress, false to decompress
+ *      unsigned workers: the number of worker threads
+ *
+ * Return: 
+ *      the exit status: EXIT_FAILURE if any file could not be converted
+ *
+ * Notes:
+ *      Exits with a message if the manifest is unreadable or no files are
+ *      given
+ *      
+ ************************/
+static int runBatch(char *program, char *manifest, char **paths, 
+                    unsigned count, bool compressing, unsigned workers)
+{
+        struct batchFile *files;
+        if (manifest != NULL) {
+                unsigned badLine;
+                files = readManifest(manifest, &count, &badLine);
+                if (files == NULL && badLine == 0) {
+                        fprintf(stderr, "%s: cannot open manifest '%s'\n", 
+                                program, manifest);
+                        exit(1);
+                } else if (files == NULL) {
+                        fprintf(stderr, "%s: %s:%u: expected an input and "
+                                "an output\n", program, manifest, badLine);
+                        exit(1);
+                }
+        } else {
+                files = malloc((count + 1) * sizeof(*files));
+                assert(files != NULL);
+                for (unsigned j = 0; j < count; j++) {
+                        files[j].input = malloc(strlen(paths[j]) + 1);
+                        assert(files[j].input != NULL);
+                        strcpy(files[j].input, paths[j]);
+                        files[j].output = batchOutputName(paths[j], 
+                                                          compressing);
+                }
+        }
+        if (count == 0) {
+                fprintf(stderr, "%s: no files to convert\n", program);
+                exit(1);
+        }
+
+        unsigned failed = compressing 
+                          ? compress40Batch(files, count, workers, overwrite)
+                          : decompress40Batch(files, count, workers, 
+                                              overwrite);
+        freeBatchFiles(files, count);
+        if (failed > 0) {
+                fprintf(stderr, "%s: %u of %u files failed\n", program, 
+                        failed, count);
+                return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+}
+
+/* Adapt the parallel codec to the mode table, using the -j thread count */
+static void compressParallel(FILE *input)
+{
+        compress40Parallel(input, threads);
+}
+
+static void decompressParallel(FILE *input)
+{
+        decompress40Parallel(input, threads);
+}
+
+/* Adapt the pipelined codec to the mode table, using -j, -q, and -v */
+static void compressPipelined(FILE *input)
+{
+        struct pipelineOptions options = { threads, queueDepth };
+        struct pipelineStats stats;
+        compress40Pipelined(input, options, &stats);
+        reportPipeline(stats);
+}
+
+static void decompressPipelined(FILE *input)
+{
+        struct pipelineOptions options = { threads, queueDepth };
+        struct pipelineStats stats;
+        decompress40Pipelined(input, options, &stats);
+        reportPipeline(stats);
+}
+
+/********** reportPipeline ********
+ *
+ * Prints how a pipelined run went to stderr when -v was given, so the
+ * stage that keeps waiting shows where the bottleneck is
+ *
+ * Parameters:
+ *      struct pipelineStats stats: the stats of the run
+ *
+ ************************/
+static void reportPipeline(struct pipelineStats stats)
+{
+        if (!verbose) {
+                return;
+        }
+        fprintf(stderr, "pipeline: %u chunks of %u rows, %u compute threads, "
+                "depth %u\n", stats.chunks, stats.rowsPerChunk, threads, 
+                queueDepth);
+        fprintf(stderr, "pipeline: stalls reader %u, compute %u, writer %u; "
+                "deepest ring %u\n", stats.readerStalls, stats.computeStalls,
+                stats.writerStalls, stats.maxDepth);
+}
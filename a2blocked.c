@@ -1,7 +1,9 @@
 #include <string.h>
 
 #include <a2blocked.h>
+#include "a2methodsExt.h"
 #include "uarray2b.h"
+#include "sharedScheduler.h"
 
 // define a private version of each function in A2Methods_T that we implement
 
@@ -9,7 +11,7 @@ typedef A2Methods_UArray2 A2;   // private abbreviation
 
 static A2 new(int width, int height, int size)
 {
-        return UArray2b_new_64K_block(width, height, size);
+        return UArray2b_new_cache_block(width, height, size);
 }
 
 static A2 new_with_blocksize(int width, int height, int size, int blocksize)
@@ -51,6 +53,11 @@ static void map_block_major(A2 array2, A2Methods_applyfun apply, void *cl)
         UArray2b_map(array2, (applyfun *) apply, cl);
 }
 
+static A2Methods_Object *span(A2 array2, int i, int j, int *length)
+{
+        return UArray2b_span(array2, i, j, length);
+}
+
 struct small_closure {
         A2Methods_smallapplyfun *apply;
         void *cl;
@@ -72,6 +79,40 @@ static void small_map_block_major(A2 a2, A2Methods_smallapplyfun apply,
         UArray2b_map(a2, apply_small, &mycl);
 }
 
+struct parallel_closure {
+        A2        array2;
+        applyfun *apply;
+        void     *cl;
+};
+
+static void map_range(unsigned first, unsigned last, void *vcl)
+{
+        struct parallel_closure *cl = vcl;
+        UArray2b_map_range(cl->array2, first, last, cl->apply, cl->cl);
+}
+
+// runs of whole blocks go to the shared scheduler, but only for an apply
+// declared safe to run concurrently; any other runs block by block here
+static void map_parallel(A2 array2, A2Methods_applyfun apply, void *cl,
+                         A2Methods_concurrency concurrency)
+{
+        struct parallel_closure mycl = { array2, (applyfun *) apply, cl };
+        unsigned blocks = UArray2b_blockcount(array2);
+        if (concurrency == A2_CONCURRENT) {
+                SharedScheduler_bands(blocks, map_range, &mycl);
+        } else {
+                map_range(0, blocks, &mycl);
+        }
+}
+
+static void small_map_parallel(A2 a2, A2Methods_smallapplyfun apply,
+                               void *cl, A2Methods_concurrency concurrency)
+{
+        struct small_closure mycl = { apply, cl };
+        map_parallel(a2, (A2Methods_applyfun *) apply_small, &mycl, 
+                     concurrency);
+}
+
 static struct A2Methods_T uarray2_methods_blocked_struct = {
         new,
         new_with_blocksize,
@@ -93,4 +134,15 @@ static struct A2Methods_T uarray2_methods_blocked_struct = {
 
 // finally the payoff: here is the exported pointer to the struct
 
-A2Methods_T uarray2_methods_blocked = &uarray2_methods_blocked_struct;
\ No newline at end of file
+A2Methods_T uarray2_methods_blocked = &uarray2_methods_blocked_struct;
+
+// and the operations beyond A2Methods_T
+
+static struct A2MethodsExt_T uarray2_methods_blocked_ext_struct = {
+        span,
+        map_parallel,
+        small_map_parallel,
+};
+
+A2MethodsExt_T uarray2_methods_blocked_ext = 
+        &uarray2_methods_blocked_ext_struct;
\ No newline at end of file
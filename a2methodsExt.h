@@ -0,0 +1,117 @@
+/*
+ *      a2methodsExt.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the operations the plain and blocked method
+ *      suites have beyond those of A2Methods_T. A2Methods_T is fixed by
+ *      a2methods.h, so they are kept in a second table for each suite,
+ *      found from the suite with A2Methods_ext.
+ */
+
+#ifndef A2METHODS_EXT
+#define A2METHODS_EXT
+
+#include <stddef.h>
+#include <string.h>
+#include "assert.h"
+#include "a2methods.h"
+#include "a2plain.h"
+#include "a2blocked.h"
+
+/* returns the cell at col and row, and sets *length to the number of cells
+   from it rightward in the row that follow it contiguously in memory */
+typedef A2Methods_Object *A2Methods_spanfun(A2Methods_UArray2 array2,
+                                            int col, int row, int *length);
+
+/* what the caller of a parallel map declares about its apply function: 
+   A2_CONCURRENT that it is safe to call from several threads at once,
+   A2_SERIAL that it is not, so the map visits every cell on the caller */
+typedef enum { A2_SERIAL, A2_CONCURRENT } A2Methods_concurrency;
+
+typedef void A2Methods_parallelmapfun(A2Methods_UArray2 array2,
+                                      A2Methods_applyfun apply, void *cl,
+                                      A2Methods_concurrency concurrency);
+typedef void A2Methods_smallparallelmapfun(A2Methods_UArray2 array2,
+                                           A2Methods_smallapplyfun apply,
+                                           void *cl,
+                                           A2Methods_concurrency 
+                                           concurrency);
+
+typedef struct A2MethodsExt_T {
+        /* the bounds are checked once per span, not once per cell */
+        A2Methods_spanfun *span;
+        /* visit every cell, from several threads at once, in no set order:
+           plain arrays are split into bands of whole rows and blocked ones
+           into runs of whole blocks, which run on the shared scheduler.
+           Only an apply declared A2_CONCURRENT is run concurrently, and
+           then never on cells of the same row (plain) or block (blocked),
+           which one thread visits in order; an A2_SERIAL one is run on the
+           caller alone, row by row (plain) or block by block (blocked) */
+        A2Methods_parallelmapfun *map_parallel;
+        A2Methods_smallparallelmapfun *small_map_parallel;
+} *A2MethodsExt_T;
+
+extern A2MethodsExt_T uarray2_methods_plain_ext;
+extern A2MethodsExt_T uarray2_methods_blocked_ext;
+
+/* returns the extension of uarray2_methods_plain or uarray2_methods_blocked,
+   or NULL for any other suite */
+static inline A2MethodsExt_T A2Methods_ext(A2Methods_T methods)
+{
+        if (methods == uarray2_methods_plain) {
+                return uarray2_methods_plain_ext;
+        } else if (methods == uarray2_methods_blocked) {
+                return uarray2_methods_blocked_ext;
+        }
+        return NULL;
+}
+
+/* returns row's cells as one array if they are contiguous, as they are in
+   the plain suite, or NULL if they are not or the row is empty */
+static inline void *A2Methods_row(A2Methods_T methods,
+                                  A2Methods_UArray2 array2, int row)
+{
+        A2MethodsExt_T ext = A2Methods_ext(methods);
+        int width = methods->width(array2);
+        if (ext == NULL || width == 0) {
+                return NULL;
+        }
+        int length;
+        void *cells = ext->span(array2, 0, row, &length);
+        return length == width ? cells : NULL;
+}
+
+/* copies row's cells, a span at a time, to or from the array cells; 
+   methods must be the plain or blocked suite */
+static inline void A2Methods_getRow(A2Methods_T methods,
+                                    A2Methods_UArray2 array2, int row,
+                                    void *cells)
+{
+        A2MethodsExt_T ext = A2Methods_ext(methods);
+        assert(ext != NULL);
+        int width = methods->width(array2);
+        size_t size = methods->size(array2);
+        int length;
+        for (int col = 0; col < width; col += length) {
+                void *span = ext->span(array2, col, row, &length);
+                memcpy((char *)cells + col * size, span, length * size);
+        }
+}
+
+static inline void A2Methods_setRow(A2Methods_T methods,
+                                    A2Methods_UArray2 array2, int row,
+                                    const void *cells)
+{
+        A2MethodsExt_T ext = A2Methods_ext(methods);
+        assert(ext != NULL);
+        int width = methods->width(array2);
+        size_t size = methods->size(array2);
+        int length;
+        for (int col = 0; col < width; col += length) {
+                void *span = ext->span(array2, col, row, &length);
+                memcpy(span, (const char *)cells + col * size, length * size);
+        }
+}
+
+#endif
@@ -9,7 +9,9 @@
 
 #include <string.h>
 #include <a2plain.h>
+#include "a2methodsExt.h"
 #include "uarray2.h"
+#include "sharedScheduler.h"
 #include <assert.h>
 
 /************************************************/
@@ -25,6 +27,12 @@ struct small_closure {
         void                    *cl;
 };
 
+struct parallel_closure {
+        A2                uarray2;
+        UArray2_applyfun *apply;
+        void             *cl;
+};
+
 /********** new ********
  *
  * Description: Creates a new A2
@@ -361,6 +369,145 @@ static void small_map_col_major(A2        a2,
         UArray2_map_col_major(a2, apply_small, &mycl);
 }
 
+/********** span ********
+ *
+ * Description: Returns the element at the given col and row and how many 
+ *              elements of its row follow it in memory
+ *
+ * Input Parameters:
+ *      A2 uarray2:     the A2 to find the element in
+ *      int col:        the column of the element
+ *      int row:        the row of the element
+ *      int *length:    where the number of elements is stored
+ *
+ * Returns:
+ *      a pointer to the element
+ *
+ * Output:
+ *      none
+ *
+ * Notes:
+ *      Will CRE if uarray2 or length is NULL, or col or row is out of 
+ *      bounds
+ *      A row of a UArray2 is contiguous, so the span runs to the end of it
+ *      
+ ************************/
+static A2Methods_Object *span(A2 uarray2, int col, int row, int *length)
+{
+        assert(uarray2 != NULL);
+        assert(length != NULL);
+        *length = UArray2_width(uarray2) - col;
+        return UArray2_at(uarray2, col, row);
+}
+
+/********** map_rows ********
+ *
+ * Description: Calls the apply function on every element of a band of 
+ *              rows, in row-major order
+ *
+ * Input Parameters:
+ *      unsigned first:         the first row of the band
+ *      unsigned last:          the row after the band
+ *      void *vcl:              the parallel_closure
+ *
+ * Returns:
+ *      none
+ *
+ * Output:
+ *      whatever the apply function specifies
+ *
+ * Notes:
+ *      Each row is found once and its elements are walked in memory
+ *      
+ ************************/
+static void map_rows(unsigned first, unsigned last, void *vcl)
+{
+        struct parallel_closure *cl = vcl;
+        int width = UArray2_width(cl->uarray2);
+        int size = UArray2_size(cl->uarray2);
+        for (unsigned row = first; row < last; row++) {
+                char *elem = UArray2_row(cl->uarray2, row);
+                for (int col = 0; col < width; col++) {
+                        cl->apply(col, row, cl->uarray2, elem, cl->cl);
+                        elem += size;
+                }
+        }
+}
+
+/********** map_parallel ********
+ *
+ * Description: Maps over an A2 in bands of rows on the shared scheduler,
+ *              if apply is declared safe to run concurrently
+ *
+ * Input Parameters:
+ *      A2 uarray2:             the A2 to map over
+ *      A2Methods_applyfun:     the apply function 
+ *      void *cl:               the closure variable 
+ *      A2Methods_concurrency:  A2_CONCURRENT if apply may be called from
+ *                              several threads at once
+ *
+ * Returns:
+ *      none
+ *
+ * Output:
+ *      whatever the apply function specifies
+ *
+ * Notes:
+ *      Will CRE if uarray2 or apply is NULL 
+ *      An A2_CONCURRENT apply is called from several threads at once, but
+ *      the elements of a row are all visited by one thread, in order; any
+ *      other apply is called on the caller alone, in row-major order
+ *      
+ ************************/
+static void map_parallel(A2 uarray2, A2Methods_applyfun apply, void *cl,
+                         A2Methods_concurrency concurrency)
+{
+        assert(uarray2 != NULL);
+        assert(apply != NULL);
+        if (UArray2_width(uarray2) == 0) {
+                return;
+        }
+        struct parallel_closure mycl = { uarray2, 
+                                         (UArray2_applyfun *)apply, cl };
+        if (concurrency == A2_CONCURRENT) {
+                SharedScheduler_bands(UArray2_height(uarray2), map_rows, 
+                                      &mycl);
+        } else {
+                map_rows(0, UArray2_height(uarray2), &mycl);
+        }
+}
+
+/********** small_map_parallel ********
+ *
+ * Description: Maps over an A2 in bands of rows on the shared scheduler,
+ *              if apply is declared safe to run concurrently
+ *
+ * Input Parameters:
+ *      A2 a2:                  the A2 to map over
+ *      A2Methods_smallapplyfun: the apply function 
+ *      void *cl:               the closure variable 
+ *      A2Methods_concurrency:  A2_CONCURRENT if apply may be called from
+ *                              several threads at once
+ *
+ * Returns:
+ *      none
+ *
+ * Output:
+ *      whatever the apply function specifies
+ *
+ * Notes:
+ *      Will CRE if a2 or apply is NULL 
+ *      
+ ************************/
+static void small_map_parallel(A2 a2, A2Methods_smallapplyfun apply, 
+                               void *cl, A2Methods_concurrency concurrency)
+{
+        assert(a2 != NULL);
+        assert(apply != NULL);
+        struct small_closure mycl = { apply, cl };
+        map_parallel(a2, (A2Methods_applyfun *)apply_small, &mycl, 
+                     concurrency);
+}
 
 static struct A2Methods_T uarray2_methods_plain_struct = {
         new,
@@ -383,3 +530,12 @@ static struct A2Methods_T uarray2_methods_plain_struct = {
 
 // finally the payoff: here is the exported pointer to the struct
 A2Methods_T uarray2_methods_plain = &uarray2_methods_plain_struct;
+
+// and the operations beyond A2Methods_T
+static struct A2MethodsExt_T uarray2_methods_plain_ext_struct = {
+        span,
+        map_parallel,
+        small_map_parallel,
+};
+
+A2MethodsExt_T uarray2_methods_plain_ext = &uarray2_methods_plain_ext_struct;
@@ -0,0 +1,611 @@
+/*
+ *      batchCodec.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation for the batch compressor and
+ *      decompressor. Every file is one task on the work-stealing scheduler
+ *      and is converted two rows at a time, like compress40Stream and 
+ *      decompress40Stream, so a worker only holds O(width) memory. Unlike
+ *      those, malformed input is reported back instead of being a checked
+ *      runtime error, so one bad file does not stop the batch. Each output is
+ *      written under a temporary name and renamed into place only once the
+ *      file is converted, so a failure never truncates or removes a file
+ *      that was already there, and a batch will not replace an existing 
+ *      file unless told to, or ever replace its own input. A task's
+ *      row buffers come from an arena it borrows from a pool, so once the
+ *      pool has an arena per worker, grown to the widest image, files are
+ *      converted without allocating row buffers.
+ */
+
+/* getline is POSIX, not C99 */
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "assert.h"
+
+#include "pnm.h"
+#include "fusedConversions.h"
+#include "ppmReader.h"
+#include "readOrWrite.h"
+#include "ppmWriter.h"
+#include "workStealing.h"
+#include "codecArena.h"
+#include "batchCodec.h"
+
+/* The maxval of every decompressed image, as in compress40.c */
+extern const unsigned CUSTOM_DENOMINATOR;
+
+/* The suffix given to compressed files */
+static const char COMPRESSED_SUFFIX[] = ".c40";
+
+/* The suffix given to decompressed files that have no COMPRESSED_SUFFIX */
+static const char DECOMPRESSED_SUFFIX[] = ".ppm";
+
+/* The format of the temporary name an output is written under, from the
+   output's name and the process id */
+static const char PARTIAL_FORMAT[] = "%s.%ld.part";
+
+/* the fileJob struct is one task: a file, whether it may replace an 
+   existing output, the pool its arena comes from, and, once it is done, 
+   why it failed, or NULL if it did not */
+struct fileJob {
+        struct batchFile *file;
+        bool compressing;
+        bool overwrite;
+        ArenaPool_T arenas;
+        const char *error;
+};
+
+static unsigned convertBatch(struct batchFile *files, unsigned count, 
+                             bool compressing, unsigned threads, 
+                             bool overwrite);
+static void convertFile(void *vjob);
+static const char *checkOutput(FILE *input, const char *output, 
+                               bool overwrite);
+static FILE *openPartial(const char *output, char **partial);
+static const char *compressFile(FILE *input, FILE *output, 
+                                CodecArena_T arena);
+static const char *decompressFile(FILE *input, FILE *output, 
+                                  CodecArena_T arena);
+
+/****************************************************************
+*                                                               *
+*                  Compression Functions                        *
+*                                                               *
+*****************************************************************/
+
+/********** compress40Batch ********
+ *
+ * Compresses every .PPM file of a batch into its own output file, several
+ * at a time, printing the status of each file to stderr as it finishes
+ *
+ * Parameters:
+ *      struct batchFile *files: the inputs and outputs
+ *      unsigned count:          the number of files
+ *      unsigned threads:        the number of worker threads
+ *      bool overwrite:          true to replace outputs that exist
+ *
+ * Return: 
+ *      the number of files that could not be compressed
+ *
+ * Expects
+ *      files and every name in it to not be null
+ *      threads to be at least 1
+ * 
+ * Notes:
+ *      Will CRE if files is null or threads is 0
+ *      Will CRE if thread creation fails
+ *      A file fails, leaving its output as it was, if the output is the 
+ *      input, or exists and overwrite is false
+ *      
+ ************************/
+unsigned compress40Batch(struct batchFile *files, unsigned count, 
+                         unsigned threads, bool overwrite)
+{
+        return convertBatch(files, count, true, threads, overwrite);
+}
+
+/********** compressFile ********
+ *
+ * Compresses one open .PPM file into an open output file, two rows at a 
+ * time
+ *
+ * Parameters:
+ *      FILE *input:        the file to be compressed
+ *      FILE *output:       the file to write the compressed image to
+ *      CodecArena_T arena: the arena holding the row buffers
+ *
+ * Return: 
+ *      NULL if the image was compressed, or why it could not be
+ *
+ * Notes:
+ *      An odd last row is never read and an odd last column is skipped
+ *      
+ ************************/
+static const char *compressFile(FILE *input, FILE *output, 
+                                CodecArena_T arena)
+{
+        PpmReader_T reader = PpmReader_new(input);
+        if (reader == NULL) {
+                return "not a PPM image";
+        }
+        unsigned fullWidth = PpmReader_width(reader);
+        unsigned denominator = PpmReader_denominator(reader);
+        unsigned width = fullWidth - fullWidth % 2;
+        unsigned height = PpmReader_height(reader);
+        height -= height % 2;
+
+        Pnm_rgb top = CodecArena_buffer(arena, ARENA_TOP_ROW, 
+                                        fullWidth * sizeof(*top));
+        Pnm_rgb bottom = CodecArena_buffer(arena, ARENA_BOTTOM_ROW, 
+                                           fullWidth * sizeof(*bottom));
+        uint32_t *words = CodecArena_buffer(arena, ARENA_WORD_ROW, 
+                                            width / 2 * sizeof(*words));
+        if (top == NULL || bottom == NULL || words == NULL) {
+                PpmReader_free(&reader);
+                return "out of memory";
+        }
+        const char *error = NULL;
+        writeCompressedHeader(output, width, height);
+
+        for (unsigned row = 0; row < height && error == NULL; row += 2) {
+                if (!PpmReader_readRow(reader, top) || 
+                    !PpmReader_readRow(reader, bottom)) {
+                        error = "malformed or truncated image";
+                } else {
+                        encodeRowPair(top, bottom, width, denominator, words);
+                        writeWordRow(output, words, width / 2);
+                }
+        }
+
+        PpmReader_free(&reader);
+        return error;
+}
+
+/****************************************************************
+*                                                               *
+*                  Decompression Functions                      *
+*                                                               *
+*****************************************************************/
+
+/********** decompress40Batch ********
+ *
+ * Decompresses every file of a batch into its own .PPM file, several at a
+ * time, printing the status of each file to stderr as it finishes
+ *
+ * Parameters:
+ *      struct batchFile *files: the inputs and outputs
+ *      unsigned count:          the number of files
+ *      unsigned threads:        the number of worker threads
+ *      bool overwrite:          true to replace outputs that exist
+ *
+ * Return: 
+ *      the number of files that could not be decompressed
+ *
+ * Expects
+ *      files and every name in it to not be null
+ *      threads to be at least 1
+ * 
+ * Notes:
+ *      Will CRE if files is null or threads is 0
+ *      Will CRE if thread creation fails
+ *      A file fails, leaving its output as it was, if the output is the 
+ *      input, or exists and overwrite is false
+ *      
+ ************************/
+unsigned decompress40Batch(struct batchFile *files, unsigned count, 
+                           unsigned threads, bool overwrite)
+{
+        return convertBatch(files, count, false, threads, overwrite);
+}
+
+/********** decompressFile ********
+ *
+ * Decompresses one open compressed file into an open output file, one row
+ * of codewords at a time
+ *
+ * Parameters:
+ *      FILE *input:        the file to be decompressed
+ *      FILE *output:       the file to write the .PPM image to
+ *      CodecArena_T arena: the arena holding the row of codewords
+ *
+ * Return: 
+ *      NULL if the image was decompressed, or why it could not be
+ *
+ * Notes:
+ *      The header is checked before anything is allocated: dimensions a 
+ *      .PPM cannot have, or that need more codewords than a mapped file 
+ *      holds, fail the file without allocating the rows they would need
+ *
+ ************************/
+static const char *decompressFile(FILE *input, FILE *output, 
+                                  CodecArena_T arena)
+{
+        unsigned width, height;
+        if (!scanCompressedHeader(input, &width, &height)) {
+                return "not a compressed image";
+        }
+        if (width > INT_MAX || height > INT_MAX) {
+                return "image too large";
+        }
+        unsigned count = width / 2;
+        unsigned rows = height / 2;
+        MappedInput_T mapped = MappedInput_new(input);
+        if (mapped != NULL && 
+            (uint64_t)count * rows * 4 > MappedInput_left(mapped)) {
+                MappedInput_free(&mapped);
+                return "truncated image";
+        }
+
+        /* each codeword row becomes two rows of 3 bytes per pixel, which
+           are decoded straight into the writer's buffer */
+        uint32_t *words = CodecArena_buffer(arena, ARENA_WORD_ROW, 
+                                            count * sizeof(*words));
+        PpmWriter_T writer = NULL;
+        if (words != NULL) {
+                writer = PpmWriter_new(output, count * 2, rows * 2, 
+                                       CUSTOM_DENOMINATOR);
+        }
+
+        const char *error = (writer == NULL) ? "out of memory" : NULL;
+        for (unsigned row = 0; row < rows && error == NULL; row++) {
+                if (!takeWordRow(input, mapped, words, count)) {
+                        error = "truncated image";
+                } else {
+                        unsigned char *top = PpmWriter_rows(writer, 2);
+                        decodeWordRow(words, count, CUSTOM_DENOMINATOR, 
+                                      top, top + 6 * (size_t)count);
+                }
+        }
+
+        /* a short write is this file's failure, whatever stdio remembers */
+        if (writer != NULL) {
+                if (!PpmWriter_flush(writer) && error == NULL) {
+                        error = "cannot write output";
+                }
+                PpmWriter_free(&writer);
+        }
+        if (mapped != NULL) {
+                MappedInput_free(&mapped);
+        }
+        return error;
+}
+
+/****************************************************************
+*                                                               *
+*           Compression and Decompression Functions             *
+*                                                               *
+*****************************************************************/
+
+/********** convertBatch ********
+ *
+ * Submits one task per file to a scheduler and counts the failures once
+ * every file is done
+ *
+ * Parameters:
+ *      struct batchFile *files: the inputs and outputs
+ *      unsigned count:          the number of files
+ *      bool compressing:        true to compress, false to decompress
+ *      unsigned threads:        the number of worker threads
+ *      bool overwrite:          true to replace outputs that exist
+ *
+ * Return: 
+ *      the number of files that could not be converted
+ *
+ * Notes:
+ *      Will CRE if files is null or threads is 0
+ *      Will CRE if memory allocation or thread creation fails
+ *      
+ ************************/
+static unsigned convertBatch(struct batchFile *files, unsigned count, 
+                             bool compressing, unsigned threads, 
+                             bool overwrite)
+{
+        assert(files != NULL);
+        assert(threads > 0);
+
+        struct fileJob *jobs = calloc(count + 1, sizeof(*jobs));
+        assert(jobs != NULL);
+        ArenaPool_T arenas = ArenaPool_new();
+        Scheduler_T scheduler = Scheduler_new(threads);
+        for (unsigned i = 0; i < count; i++) {
+                jobs[i].file = &files[i];
+                jobs[i].compressing = compressing;
+                jobs[i].overwrite = overwrite;
+                jobs[i].arenas = arenas;
+                Scheduler_submit(scheduler, convertFile, &jobs[i]);
+        }
+        Scheduler_free(&scheduler);
+        ArenaPool_free(&arenas);
+
+        unsigned failed = 0;
+        for (unsigned i = 0; i < count; i++) {
+                failed += (jobs[i].error != NULL);
+        }
+        free(jobs);
+        return failed;
+}
+
+/********** convertFile ********
+ *
+ * Task that opens one file of a batch, converts it into a temporary file
+ * that is renamed to its output on success, and reports how that went on
+ * stderr
+ *
+ * Parameters:
+ *      void *vjob: the struct fileJob to convert
+ *
+ * Return: 
+ *      none
+ *
+ * Notes:
+ *      Removes the temporary file if the file could not be converted, 
+ *      leaving any earlier output untouched
+ *      Borrows an arena from the batch's pool while the file is converted
+ *      
+ ************************/
+static void convertFile(void *vjob)
+{
+        struct fileJob *job = vjob;
+        struct batchFile *file = job->file;
+
+        FILE *input = fopen(file->input, "rb");
+        FILE *output = NULL;
+        char *partial = NULL;
+        if (input == NULL) {
+                job->error = "cannot open input";
+        } else if ((job->error = checkOutput(input, file->output, 
+                                             job->overwrite)) != NULL) {
+                /* the output is left alone */
+        } else if ((output = openPartial(file->output, &partial)) == NULL) {
+                job->error = "cannot create output";
+        } else {
+                CodecArena_T arena = ArenaPool_take(job->arenas);
+                if (job->compressing) {
+                        job->error = compressFile(input, output, arena);
+                } else {
+                        job->error = decompressFile(input, output, arena);
+                }
+                ArenaPool_give(job->arenas, arena);
+        }
+
+        if (input != NULL) {
+                fclose(input);
+        }
+        if (output != NULL) {
+                bool written = !ferror(output);
+                written = (fclose(output) == 0) && written;
+                if (job->error == NULL && !written) {
+                        job->error = "cannot write output";
+                }
+                if (job->error == NULL && 
+                    rename(partial, file->output) != 0) {
+                        job->error = "cannot replace output";
+                }
+                if (job->error != NULL) {
+                        remove(partial);
+                }
+        }
+        free(partial);
+
+        if (job->error == NULL) {
+                fprintf(stderr, "%s -> %s: ok\n", file->input, file->output);
+        } else {
+                fprintf(stderr, "%s: %s\n", file->input, job->error);
+        }
+}
+
+/********** checkOutput ********
+ *
+ * Checks that a file's output may be written: it must not be the input, 
+ * and must not exist at all unless overwrite is true
+ *
+ * Parameters:
+ *      FILE *input:        the open input
+ *      const char *output: the name of the output
+ *      bool overwrite:     true to allow replacing an existing output
+ *
+ * Return: 
+ *      NULL if the output may be written, or why it may not
+ *
+ * Notes:
+ *      The input and output are the same file if they have the same device
+ *      and inode, whatever names they were given by
+ *      
+ ************************/
+static const char *checkOutput(FILE *input, const char *output, 
+                               bool overwrite)
+{
+        struct stat existing, source;
+        if (stat(output, &existing) != 0) {
+                return NULL;
+        }
+        if (fstat(fileno(input), &source) == 0 && 
+            source.st_dev == existing.st_dev && 
+            source.st_ino == existing.st_ino) {
+                return "output is the input";
+        }
+        return overwrite ? NULL : "output exists (use -F to replace it)";
+}
+
+/********** openPartial ********
+ *
+ * Creates the temporary file an output is written to before it is renamed
+ * into place, in the same directory so that the rename cannot fail for 
+ * crossing file systems
+ *
+ * Parameters:
+ *      const char *output: the name of the output
+ *      char **partial:     where to store the temporary name, which the 
+ *                          caller must free, even if NULL is returned
+ *
+ * Return: 
+ *      the temporary file opened for writing, or NULL if it cannot be made
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails
+ *      The file is made with the permissions fopen would give the output,
+ *      and never replaces a file that is already there
+ *      
+ ************************/
+static FILE *openPartial(const char *output, char **partial)
+{
+        long pid = getpid();
+        size_t length = snprintf(NULL, 0, PARTIAL_FORMAT, output, pid) + 1;
+        *partial = malloc(length);
+        assert(*partial != NULL);
+        snprintf(*partial, length, PARTIAL_FORMAT, output, pid);
+
+        int fd = open(*partial, O_WRONLY | O_CREAT | O_EXCL, 0666);
+        if (fd < 0) {
+                return NULL;
+        }
+        FILE *fp = fdopen(fd, "wb");
+        if (fp == NULL) {
+                close(fd);
+                remove(*partial);
+        }
+        return fp;
+}
+
+/********** batchOutputName ********
+ *
+ * Names the output file of an input given on the command line: compressed
+ * files get COMPRESSED_SUFFIX added, and decompressed files lose it, or 
+ * get DECOMPRESSED_SUFFIX if they do not have it
+ *
+ * Parameters:
+ *      char *input:      the name of the input file
+ *      bool compressing: true to compress, false to decompress
+ *
+ * Return: 
+ *      the name of the output file, which the caller must free
+ *
+ * Notes:
+ *      Will CRE if input is null or memory allocation fails
+ *      
+ ************************/
+char *batchOutputName(char *input, bool compressing)
+{
+        assert(input != NULL);
+        size_t length = strlen(input);
+        size_t suffix = strlen(COMPRESSED_SUFFIX);
+        char *output = malloc(length + sizeof(DECOMPRESSED_SUFFIX) + 
+                              sizeof(COMPRESSED_SUFFIX));
+        assert(output != NULL);
+
+        if (compressing) {
+                sprintf(output, "%s%s", input, COMPRESSED_SUFFIX);
+        } else if (length > suffix && 
+                   strcmp(input + length - suffix, COMPRESSED_SUFFIX) == 0) {
+                sprintf(output, "%.*s", (int)(length - suffix), input);
+        } else {
+                sprintf(output, "%s%s", input, DECOMPRESSED_SUFFIX);
+        }
+        return output;
+}
+
+/********** readManifest ********
+ *
+ * Reads a manifest of files to convert: each line holds the name of an 
+ * input and of its output, separated by whitespace. Blank lines and lines
+ * starting with # are skipped
+ *
+ * Parameters:
+ *      char *path:        the name of the manifest
+ *      unsigned *count:   where to store the number of files
+ *      unsigned *badLine: where to store the line that could not be read
+ *
+ * Return: 
+ *      the files, to be freed with freeBatchFiles, or NULL if the manifest
+ *      cannot be opened (*badLine is 0) or a line is malformed
+ *
+ * Notes:
+ *      Will CRE if any argument is null or memory allocation fails
+ *      
+ ************************/
+struct batchFile *readManifest(char *path, unsigned *count, 
+                               unsigned *badLine)
+{
+        assert(path != NULL && count != NULL && badLine != NULL);
+        *count = 0;
+        *badLine = 0;
+        FILE *fp = fopen(path, "r");
+        if (fp == NULL) {
+                return NULL;
+        }
+
+        unsigned capacity = 16;
+        struct batchFile *files = malloc(capacity * sizeof(*files));
+        assert(files != NULL);
+        char *line = NULL;
+        size_t lineSize = 0;
+
+        for (unsigned number = 1; getline(&line, &lineSize, fp) != -1; 
+             number++) {
+                size_t start = strspn(line, " \t\r\n");
+                if (line[start] == '\0' || line[start] == '#') {
+                        continue;
+                }
+
+                char *input = malloc(strlen(line) + 1);
+                char *output = malloc(strlen(line) + 1);
+                char extra;
+                assert(input != NULL && output != NULL);
+                if (sscanf(line, "%s %s %c", input, output, &extra) != 2) {
+                        free(input);
+                        free(output);
+                        *badLine = number;
+                        break;
+                }
+
+                if (*count == capacity) {
+                        capacity *= 2;
+                        files = realloc(files, capacity * sizeof(*files));
+                        assert(files != NULL);
+                }
+                files[*count].input = input;
+                files[*count].output = output;
+                (*count)++;
+        }
+
+        free(line);
+        fclose(fp);
+        if (*badLine != 0) {
+                freeBatchFiles(files, *count);
+                *count = 0;
+                return NULL;
+        }
+        return files;
+}
+
+/********** freeBatchFiles ********
+ *
+ * Frees files read by readManifest, or any files whose names were all 
+ * allocated with malloc
+ *
+ * Parameters:
+ *      struct batchFile *files: the files to free
+ *      unsigned count:          the number of files
+ *
+ ************************/
+void freeBatchFiles(struct batchFile *files, unsigned count)
+{
+        if (files == NULL) {
+                return;
+        }
+        for (unsigned i = 0; i < count; i++) {
+                free(files[i].input);
+                free(files[i].output);
+        }
+        free(files);
+}
@@ -0,0 +1,40 @@
+/*
+ *      batchCodec.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the batch compressor and
+ *      decompressor, which converts many files in one process, each to its
+ *      own output file, on a pool of worker threads. A file that cannot be
+ *      converted is reported on stderr and the rest of the batch carries on.
+ *      Outputs are only replaced when a file converts, never with the file
+ *      being read, and only when overwrite is true if they already exist.
+ */
+
+#ifndef BATCH_CODEC
+#define BATCH_CODEC
+
+#include <stdbool.h>
+
+/* one file of a batch: where to read it and where to write its output */
+struct batchFile {
+        char *input;
+        char *output;
+};
+
+/* each returns the number of files that could not be converted */
+unsigned compress40Batch(struct batchFile *files, unsigned count, 
+                         unsigned threads, bool overwrite);
+unsigned decompress40Batch(struct batchFile *files, unsigned count, 
+                           unsigned threads, bool overwrite);
+
+/* names the output of input: a.ppm -> a.ppm.c40 -> a.ppm */
+char *batchOutputName(char *input, bool compressing);
+
+/* reads "input output" lines, skipping blank lines and # comments; returns
+   NULL and sets *badLine (0 if the manifest cannot be opened) on failure */
+struct batchFile *readManifest(char *path, unsigned *count, 
+                               unsigned *badLine);
+void freeBatchFiles(struct batchFile *files, unsigned count);
+
+#endif
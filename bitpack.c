@@ -9,6 +9,7 @@
 */
 
 #include "bitpack.h"
+#include "bitpackInline.h"
 #include "assert.h"
 #include "except.h"
 
@@ -19,9 +20,7 @@ const unsigned WORD_SIZE = 64;
 /* Define a message to be thrown in the case of a bitpack overflow */
 Except_T Bitpack_Overflow = { "Overflow packing bits" };
 
-/* Our helper functions for shifting */
-uint64_t unsignedRightShift(uint64_t n, unsigned width);
-int64_t signedRightShift(int64_t value, unsigned shift);
+/* Our helper function for shifting */
 uint64_t leftShift(uint64_t value, unsigned shift);
 
 
@@ -132,22 +131,13 @@ uint64_t Bitpack_getu(uint64_t word, unsigned width, unsigned lsb)
         assert(width + lsb <= WORD_SIZE);
         assert(width <= WORD_SIZE);
 
-        /* Create our mask with all 1's */
-        uint64_t mask = ~0;
-        /* Left shift mask by 64 - width to propogate 0's */
-        mask = leftShift(mask, WORD_SIZE - width);
-
-        /* Right shift mask by 64 - (lsb + width) to propogate 0's 
-           on other sise */
-        mask = unsignedRightShift(mask, WORD_SIZE - (lsb + width));
-        
-        /* Bitwise and the mask with the word to update the value */
-        uint64_t value = mask & word;
+        /* A field of no bits holds 0 */
+        if (width == 0) {
+                return (uint64_t)0;
+        }
 
-        /* Right shift value by LSB to finish this process */
-        value = unsignedRightShift(value, lsb);
-        
-        return value;
+        /* With the arguments checked, the inline version is safe */
+        return BitpackInline_getu(word, width, lsb);
 }
 
 /********** Bitpack_gets ********
@@ -178,14 +168,13 @@ int64_t Bitpack_gets(uint64_t word, unsigned width, unsigned lsb)
         assert(width + lsb <= WORD_SIZE);
         assert(width <= 64);
         
-        /* Perform getu and store result as a signed int */
-        int64_t value = (int64_t)Bitpack_getu(word, width, lsb);
+        /* A field of no bits holds 0 */
+        if (width == 0) {
+                return (int64_t)0;
+        }
 
-        /* Perform a left and then right shifts to update our value */
-        value = leftShift(value, (WORD_SIZE - width));
-        value = signedRightShift(value, (WORD_SIZE - width));
-        
-        return value;
+        /* With the arguments checked, the inline version is safe */
+        return BitpackInline_gets(word, width, lsb);
 }
 
 /********** Bitpack_newu ********
@@ -224,28 +213,8 @@ uint64_t Bitpack_newu(uint64_t word, unsigned width, unsigned lsb,
                 RAISE(Bitpack_Overflow);
         }
         
-        /* Create our high mask */
-        uint64_t maskHigh = ~(uint64_t)0;
-        maskHigh = leftShift(maskHigh, (lsb + width));
-
-        /* Create our low mask */
-        uint64_t maskLow = ~(uint64_t)0;
-        maskLow = unsignedRightShift(maskLow, (WORD_SIZE - lsb));
-        
-        /* Bitwise or the two masks to get our actual mask */
-        uint64_t mask = maskHigh | maskLow;
-
-        /* Bitwise and the word with teh mask to get a cleared spot for where
-           we want value to be compared */
-        uint64_t clearedValue = word & mask;
-
-        /* Shift value by LSB to align with the cleared value */
-        uint64_t shiftedValue = leftShift(value, lsb);
-
-        /* Bitwise or the shifted value and the cleared value to get our
-           updated word */
-        uint64_t newWord = shiftedValue | clearedValue;
-        return newWord;
+        /* value fits, so width is not 0 and the inline version is safe */
+        return BitpackInline_newu(word, width, lsb, value);
 }
 
 /********** Bitpack_news ********
@@ -283,84 +252,10 @@ uint64_t Bitpack_news(uint64_t word, unsigned width, unsigned lsb,
                 RAISE(Bitpack_Overflow);
         }
 
-        /* Cast our value to an unsigned int */
-        uint64_t uValue = (uint64_t)value;
-
-        /* Left shift this value by word_size - width to propogate 0's */
-        uValue = leftShift(uValue, (WORD_SIZE - width));
-
-        /* Right shift this value by the same amount to propogate 0's 
-           on other side*/
-        uValue = unsignedRightShift(uValue, (WORD_SIZE - width));
-
-        /* Call Bitpack_newu on this value and store the result */
-        uValue = Bitpack_newu(word, width, lsb, uValue);
-        
-        return uValue;
+        /* value fits, so width is not 0 and the inline version is safe */
+        return BitpackInline_news(word, width, lsb, value);
 }       
 
-/********** unsignedRightShift ********
- *
- *  A helper function to right shift an unsigned value by the 
- *  specified shift amount
- *
- * Parameters:
- *      uint64_t value: the value we want to shift
- *      unsigned shift: the amount we want to shift value to the right
- *
- * Return: 
- *      The value after it has been shifted
- *
- * Expects
- *      none
- * 
- * Notes:
- *      none
- *      
- ************************/
-uint64_t unsignedRightShift(uint64_t value, unsigned shift)
-{
-        /* If the shift is greater than 64, return all 0s */
-        if (shift >= WORD_SIZE) {
-                uint64_t clearedBits = (uint64_t)0;
-                return clearedBits;
-        }
-        /* Otherwise, perform the right shift and store in an unsigned */
-        uint64_t result = value >> shift;
-        return result;
-}
-
-/********** signedRightShift ********
- *
- *  A helper function to right shift a signed value by the 
- *  specified shift amount
- *
- * Parameters:
- *      uint64_t value: the value we want to shift
- *      unsigned shift: the amount we want to shift value to the right
- *
- * Return: 
- *      The value after it has been shifted
- *
- * Expects
- *      none
- * 
- * Notes:
- *      none
- *      
- ************************/
-int64_t signedRightShift(int64_t value, unsigned shift)
-{
-        /* If the shift is greater than 64, return all 0s */
-        if (shift >= WORD_SIZE) {
-                uint64_t clearedBits = (uint64_t)0;
-                return clearedBits;
-        }
-        /* Otherwise, perform the right shift and store in a signed */
-        int64_t result = (value >> shift);
-        return result;
-}
-
 /********** leftShift ********
  *
  *  A helper function to left shift a value (signed OR unsigned) by the 
@@ -0,0 +1,60 @@
+/*
+ *      bitpackInline.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains unchecked, inline versions of the Bitpack get
+ *      and new functions, for loops whose widths and lsbs are constants
+ *      and whose values are known to fit. They neither assert nor raise
+ *      Bitpack_Overflow and have no branches, so with constant arguments
+ *      each one compiles down to a shift and a mask. Anything packing
+ *      values it has not checked should use the Bitpack interface instead.
+ */
+
+#ifndef BITPACK_INLINE_H
+#define BITPACK_INLINE_H
+
+#include <stdint.h>
+
+/* Every function expects 1 <= width <= 64 and width + lsb <= 64, and the
+   new functions expect value to fit in width bits. Nothing checks this: a
+   width of 0 shifts by 64, which C leaves undefined, so a caller that can
+   see a zero-width field must use the checked Bitpack functions, which 
+   handle it */
+
+/* width low bits set; width must be at least 1, since 64 - width must be
+   less than 64 for the shift to be defined */
+static inline uint64_t BitpackInline_mask(unsigned width)
+{
+        return ~(uint64_t)0 >> (64 - width);
+}
+
+static inline uint64_t BitpackInline_getu(uint64_t word, unsigned width,
+                                          unsigned lsb)
+{
+        return (word >> lsb) & BitpackInline_mask(width);
+}
+
+/* shifts the field to the top of the word and arithmetically back down;
+   like the mask, this needs width to be at least 1 */
+static inline int64_t BitpackInline_gets(uint64_t word, unsigned width,
+                                         unsigned lsb)
+{
+        return (int64_t)(word << (64 - width - lsb)) >> (64 - width);
+}
+
+static inline uint64_t BitpackInline_newu(uint64_t word, unsigned width,
+                                          unsigned lsb, uint64_t value)
+{
+        uint64_t field = BitpackInline_mask(width) << lsb;
+        return (word & ~field) | ((value << lsb) & field);
+}
+
+/* the two's complement bits of value above the field are masked off */
+static inline uint64_t BitpackInline_news(uint64_t word, unsigned width,
+                                          unsigned lsb, int64_t value)
+{
+        return BitpackInline_newu(word, width, lsb, (uint64_t)value);
+}
+
+#endif
@@ -0,0 +1,440 @@
+/*
+ *      blockKernels.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation of the block kernels. Each
+ *      loads two pixels' worth of every row a block covers, splits the
+ *      even (left) pixels from the odd (right) ones, and then does what
+ *      discreteCosineTransform and averageOfFour do, in the same order:
+ *      float sums, a float product for a and a double product for b, c
+ *      and d, and rounding half away from zero the way round() does.
+ */
+
+#include "assert.h"
+
+#include "cvPlanes.h"
+#include "simdLevel.h"
+#include "blockKernels.h"
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+
+/* The float nearest 0.3, which is what capOrNoCapDCT gives when it
+   returns the double 0.3 as a float */
+static const float DCT_LIMIT = 0.3;
+
+/****************************************************************
+*                                                               *
+*                         SSE4.1 Kernels                        *
+*                                                               *
+*****************************************************************/
+
+/* x rounded half away from zero, like round(), as integers */
+SIMD_TARGET_SSE41
+static inline __m128 roundAwaySse(__m128 x)
+{
+        __m128 whole = _mm_round_ps(x, _MM_FROUND_TO_ZERO |
+                                       _MM_FROUND_NO_EXC);
+        __m128 part = _mm_sub_ps(x, whole);
+        __m128 one = _mm_set1_ps(1.0f);
+        __m128 up = _mm_and_ps(_mm_cmpge_ps(part, _mm_set1_ps(0.5f)), one);
+        __m128 down = _mm_and_ps(_mm_cmple_ps(part, _mm_set1_ps(-0.5f)),
+                                 one);
+        return _mm_sub_ps(_mm_add_ps(whole, up), down);
+}
+
+SIMD_TARGET_SSE41
+static inline __m128d roundAwayHalfSse(__m128d x)
+{
+        __m128d whole = _mm_round_pd(x, _MM_FROUND_TO_ZERO |
+                                        _MM_FROUND_NO_EXC);
+        __m128d part = _mm_sub_pd(x, whole);
+        __m128d one = _mm_set1_pd(1.0);
+        __m128d up = _mm_and_pd(_mm_cmpge_pd(part, _mm_set1_pd(0.5)), one);
+        __m128d down = _mm_and_pd(_mm_cmple_pd(part, _mm_set1_pd(-0.5)),
+                                  one);
+        return _mm_sub_pd(_mm_add_pd(whole, up), down);
+}
+
+/* a coefficient clamped to +-0.3, times 50.0 in double, rounded */
+SIMD_TARGET_SSE41
+static inline __m128i quantizeDctSse(__m128 coefficient)
+{
+        __m128 limit = _mm_set1_ps(DCT_LIMIT);
+        coefficient = _mm_min_ps(_mm_max_ps(coefficient,
+                                            _mm_sub_ps(_mm_setzero_ps(),
+                                                       limit)), limit);
+
+        __m128d fifty = _mm_set1_pd(50.0);
+        __m128d low = _mm_mul_pd(_mm_cvtps_pd(coefficient), fifty);
+        __m128d high = _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(coefficient,
+                                                             coefficient)),
+                                  fifty);
+        return _mm_unpacklo_epi64(_mm_cvtpd_epi32(roundAwayHalfSse(low)),
+                                  _mm_cvtpd_epi32(roundAwayHalfSse(high)));
+}
+
+/* ((((0 + v1) + v2) + v3) + v4) / 4, as averageOfFour sums */
+SIMD_TARGET_SSE41
+static inline __m128 averageSse(__m128 v1, __m128 v2, __m128 v3, __m128 v4)
+{
+        __m128 sum = _mm_add_ps(_mm_setzero_ps(), v1);
+        sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(sum, v2), v3), v4);
+        return _mm_div_ps(sum, _mm_set1_ps(4.0f));
+}
+
+SIMD_TARGET_SSE41
+static unsigned quantizeSse(CvPlanes_T planes, unsigned col, unsigned row,
+                            unsigned count, struct quantizedBlocks *blocks)
+{
+        size_t top = CvPlanes_index(planes, col, row);
+        size_t bottom = top + planes->stride;
+        __m128 quarter = _mm_set1_ps(4.0f);
+        unsigned i = 0;
+
+/* the left (even) and right (odd) pixels of 4 blocks of a row */
+#define SPLIT_SSE(row, left, right) do {                                     \
+                __m128 first = _mm_loadu_ps((row) + 2 * i);                  \
+                __m128 second = _mm_loadu_ps((row) + 2 * i + 4);             \
+                left = _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));\
+                right = _mm_shuffle_ps(first, second,                        \
+                                       _MM_SHUFFLE(3, 1, 3, 1));             \
+        } while (0)
+
+        for (; i + 4 <= count; i += 4) {
+                __m128 y1, y2, y3, y4, v1, v2, v3, v4;
+                SPLIT_SSE(planes->Y + top, y1, y2);
+                SPLIT_SSE(planes->Y + bottom, y3, y4);
+
+                __m128 a = _mm_add_ps(_mm_add_ps(_mm_add_ps(y4, y3), y2), y1);
+                __m128 b = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(y4, y3), y2), y1);
+                __m128 c = _mm_sub_ps(_mm_add_ps(_mm_sub_ps(y4, y3), y2), y1);
+                __m128 d = _mm_add_ps(_mm_sub_ps(_mm_sub_ps(y4, y3), y2), y1);
+
+                a = _mm_mul_ps(_mm_div_ps(a, quarter), _mm_set1_ps(511.0f));
+                _mm_storeu_si128((__m128i *)(blocks->fields.a + i),
+                                 _mm_cvtps_epi32(roundAwaySse(a)));
+                _mm_storeu_si128((__m128i *)(blocks->fields.b + i),
+                                 quantizeDctSse(_mm_div_ps(b, quarter)));
+                _mm_storeu_si128((__m128i *)(blocks->fields.c + i),
+                                 quantizeDctSse(_mm_div_ps(c, quarter)));
+                _mm_storeu_si128((__m128i *)(blocks->fields.d + i),
+                                 quantizeDctSse(_mm_div_ps(d, quarter)));
+
+                SPLIT_SSE(planes->Pb + top, v1, v2);
+                SPLIT_SSE(planes->Pb + bottom, v3, v4);
+                _mm_storeu_ps(blocks->pbAverage + i,
+                              averageSse(v1, v2, v3, v4));
+                SPLIT_SSE(planes->Pr + top, v1, v2);
+                SPLIT_SSE(planes->Pr + bottom, v3, v4);
+                _mm_storeu_ps(blocks->prAverage + i,
+                              averageSse(v1, v2, v3, v4));
+        }
+#undef SPLIT_SSE
+
+        return i;
+}
+
+/****************************************************************
+*                                                               *
+*                          AVX2 Kernels                         *
+*                                                               *
+*****************************************************************/
+
+SIMD_TARGET_AVX2
+static inline __m256 roundAwayAvx2(__m256 x)
+{
+        __m256 whole = _mm256_round_ps(x, _MM_FROUND_TO_ZERO |
+                                          _MM_FROUND_NO_EXC);
+        __m256 part = _mm256_sub_ps(x, whole);
+        __m256 one = _mm256_set1_ps(1.0f);
+        __m256 up = _mm256_and_ps(_mm256_cmp_ps(part, _mm256_set1_ps(0.5f),
+                                                _CMP_GE_OQ), one);
+        __m256 down = _mm256_and_ps(_mm256_cmp_ps(part,
+                                                  _mm256_set1_ps(-0.5f),
+                                                  _CMP_LE_OQ), one);
+        return _mm256_sub_ps(_mm256_add_ps(whole, up), down);
+}
+
+SIMD_TARGET_AVX2
+static inline __m256d roundAwayHalfAvx2(__m256d x)
+{
+        __m256d whole = _mm256_round_pd(x, _MM_FROUND_TO_ZERO |
+                                           _MM_FROUND_NO_EXC);
+        __m256d part = _mm256_sub_pd(x, whole);
+        __m256d one = _mm256_set1_pd(1.0);
+        __m256d up = _mm256_and_pd(_mm256_cmp_pd(part, _mm256_set1_pd(0.5),
+                                                 _CMP_GE_OQ), one);
+        __m256d down = _mm256_and_pd(_mm256_cmp_pd(part,
+                                                   _mm256_set1_pd(-0.5),
+                                                   _CMP_LE_OQ), one);
+        return _mm256_sub_pd(_mm256_add_pd(whole, up), down);
+}
+
+SIMD_TARGET_AVX2
+static inline __m256i quantizeDctAvx2(__m256 coefficient)
+{
+        __m256 limit = _mm256_set1_ps(DCT_LIMIT);
+        coefficient = _mm256_min_ps(_mm256_max_ps(coefficient,
+                                        _mm256_sub_ps(_mm256_setzero_ps(),
+                                                      limit)), limit);
+
+        __m256d fifty = _mm256_set1_pd(50.0);
+        __m256d low = _mm256_mul_pd(_mm256_cvtps_pd(
+                        _mm256_castps256_ps128(coefficient)), fifty);
+        __m256d high = _mm256_mul_pd(_mm256_cvtps_pd(
+                        _mm256_extractf128_ps(coefficient, 1)), fifty);
+        return _mm256_insertf128_si256(_mm256_castsi128_si256(
+                        _mm256_cvtpd_epi32(roundAwayHalfAvx2(low))),
+                        _mm256_cvtpd_epi32(roundAwayHalfAvx2(high)), 1);
+}
+
+SIMD_TARGET_AVX2
+static inline __m256 averageAvx2(__m256 v1, __m256 v2, __m256 v3, __m256 v4)
+{
+        __m256 sum = _mm256_add_ps(_mm256_setzero_ps(), v1);
+        sum = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(sum, v2), v3), v4);
+        return _mm256_div_ps(sum, _mm256_set1_ps(4.0f));
+}
+
+SIMD_TARGET_AVX2
+static unsigned quantizeAvx2(CvPlanes_T planes, unsigned col, unsigned row,
+                             unsigned count, struct quantizedBlocks *blocks)
+{
+        size_t top = CvPlanes_index(planes, col, row);
+        size_t bottom = top + planes->stride;
+        __m256 quarter = _mm256_set1_ps(4.0f);
+        unsigned i = 0;
+
+/* the left (even) and right (odd) pixels of 8 blocks of a row; the
+   shuffle works within 128-bit lanes, so the permute puts the pairs of
+   blocks back in order */
+#define SPLIT_AVX2(row, left, right) do {                                    \
+                __m256 first = _mm256_loadu_ps((row) + 2 * i);               \
+                __m256 second = _mm256_loadu_ps((row) + 2 * i + 8);          \
+                left = _mm256_castpd_ps(_mm256_permute4x64_pd(               \
+                        _mm256_castps_pd(_mm256_shuffle_ps(first, second,    \
+                                _MM_SHUFFLE(2, 0, 2, 0))),                   \
+                        _MM_SHUFFLE(3, 1, 2, 0)));                           \
+                right = _mm256_castpd_ps(_mm256_permute4x64_pd(              \
+                        _mm256_castps_pd(_mm256_shuffle_ps(first, second,    \
+                                _MM_SHUFFLE(3, 1, 3, 1))),                   \
+                        _MM_SHUFFLE(3, 1, 2, 0)));                           \
+        } while (0)
+
+        for (; i + 8 <= count; i += 8) {
+                __m256 y1, y2, y3, y4, v1, v2, v3, v4;
+                SPLIT_AVX2(planes->Y + top, y1, y2);
+                SPLIT_AVX2(planes->Y + bottom, y3, y4);
+
+                __m256 a = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(y4, y3),
+                                                       y2), y1);
+                __m256 b = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(y4, y3),
+                                                       y2), y1);
+                __m256 c = _mm256_sub_ps(_mm256_add_ps(_mm256_sub_ps(y4, y3),
+                                                       y2), y1);
+                __m256 d = _mm256_add_ps(_mm256_sub_ps(_mm256_sub_ps(y4, y3),
+                                                       y2), y1);
+
+                a = _mm256_mul_ps(_mm256_div_ps(a, quarter),
+                                  _mm256_set1_ps(511.0f));
+                _mm256_storeu_si256((__m256i *)(blocks->fields.a + i),
+                                    _mm256_cvtps_epi32(roundAwayAvx2(a)));
+                _mm256_storeu_si256((__m256i *)(blocks->fields.b + i),
+                                    quantizeDctAvx2(_mm256_div_ps(b,
+                                                                  quarter)));
+                _mm256_storeu_si256((__m256i *)(blocks->fields.c + i),
+                                    quantizeDctAvx2(_mm256_div_ps(c,
+                                                                  quarter)));
+                _mm256_storeu_si256((__m256i *)(blocks->fields.d + i),
+                                    quantizeDctAvx2(_mm256_div_ps(d,
+                                                                  quarter)));
+
+                SPLIT_AVX2(planes->Pb + top, v1, v2);
+                SPLIT_AVX2(planes->Pb + bottom, v3, v4);
+                _mm256_storeu_ps(blocks->pbAverage + i,
+                                 averageAvx2(v1, v2, v3, v4));
+                SPLIT_AVX2(planes->Pr + top, v1, v2);
+                SPLIT_AVX2(planes->Pr + bottom, v3, v4);
+                _mm256_storeu_ps(blocks->prAverage + i,
+                                 averageAvx2(v1, v2, v3, v4));
+        }
+#undef SPLIT_AVX2
+
+        return i;
+}
+
+/****************************************************************
+*                                                               *
+*                        AVX-512 Kernels                        *
+*                                                               *
+*****************************************************************/
+
+SIMD_TARGET_AVX512
+static inline __m512 roundAwayAvx512(__m512 x)
+{
+        __m512 whole = _mm512_roundscale_ps(x, _MM_FROUND_TO_ZERO |
+                                               _MM_FROUND_NO_EXC);
+        __m512 part = _mm512_sub_ps(x, whole);
+        __m512 one = _mm512_set1_ps(1.0f);
+        __mmask16 up = _mm512_cmp_ps_mask(part, _mm512_set1_ps(0.5f),
+                                          _CMP_GE_OQ);
+        __mmask16 down = _mm512_cmp_ps_mask(part, _mm512_set1_ps(-0.5f),
+                                            _CMP_LE_OQ);
+        whole = _mm512_mask_add_ps(whole, up, whole, one);
+        return _mm512_mask_sub_ps(whole, down, whole, one);
+}
+
+SIMD_TARGET_AVX512
+static inline __m512d roundAwayHalfAvx512(__m512d x)
+{
+        __m512d whole = _mm512_roundscale_pd(x, _MM_FROUND_TO_ZERO |
+                                                _MM_FROUND_NO_EXC);
+        __m512d part = _mm512_sub_pd(x, whole);
+        __m512d one = _mm512_set1_pd(1.0);
+        __mmask8 up = _mm512_cmp_pd_mask(part, _mm512_set1_pd(0.5),
+                                         _CMP_GE_OQ);
+        __mmask8 down = _mm512_cmp_pd_mask(part, _mm512_set1_pd(-0.5),
+                                           _CMP_LE_OQ);
+        whole = _mm512_mask_add_pd(whole, up, whole, one);
+        return _mm512_mask_sub_pd(whole, down, whole, one);
+}
+
+SIMD_TARGET_AVX512
+static inline __m512i quantizeDctAvx512(__m512 coefficient)
+{
+        __m512 limit = _mm512_set1_ps(DCT_LIMIT);
+        coefficient = _mm512_min_ps(_mm512_max_ps(coefficient,
+                                        _mm512_sub_ps(_mm512_setzero_ps(),
+                                                      limit)), limit);
+
+        __m512d fifty = _mm512_set1_pd(50.0);
+        __m512d low = _mm512_mul_pd(_mm512_cvtps_pd(
+                        _mm512_castps512_ps256(coefficient)), fifty);
+        __m512d high = _mm512_mul_pd(_mm512_cvtps_pd(_mm256_castpd_ps(
+                        _mm512_extractf64x4_pd(_mm512_castps_pd(coefficient),
+                                               1))), fifty);
+        return _mm512_inserti64x4(_mm512_castsi256_si512(
+                        _mm512_cvtpd_epi32(roundAwayHalfAvx512(low))),
+                        _mm512_cvtpd_epi32(roundAwayHalfAvx512(high)), 1);
+}
+
+SIMD_TARGET_AVX512
+static inline __m512 averageAvx512(__m512 v1, __m512 v2, __m512 v3,
+                                   __m512 v4)
+{
+        __m512 sum = _mm512_add_ps(_mm512_setzero_ps(), v1);
+        sum = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(sum, v2), v3), v4);
+        return _mm512_div_ps(sum, _mm512_set1_ps(4.0f));
+}
+
+SIMD_TARGET_AVX512
+static unsigned quantizeAvx512(CvPlanes_T planes, unsigned col,
+                               unsigned row, unsigned count,
+                               struct quantizedBlocks *blocks)
+{
+        size_t top = CvPlanes_index(planes, col, row);
+        size_t bottom = top + planes->stride;
+        __m512 quarter = _mm512_set1_ps(4.0f);
+        __m512i evens = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14,
+                                          16, 18, 20, 22, 24, 26, 28, 30);
+        __m512i odds = _mm512_add_epi32(evens, _mm512_set1_epi32(1));
+        unsigned i = 0;
+
+/* the left (even) and right (odd) pixels of 16 blocks of a row */
+#define SPLIT_AVX512(row, left, right) do {                                  \
+                __m512 first = _mm512_loadu_ps((row) + 2 * i);               \
+                __m512 second = _mm512_loadu_ps((row) + 2 * i + 16);         \
+                left = _mm512_permutex2var_ps(first, evens, second);         \
+                right = _mm512_permutex2var_ps(first, odds, second);         \
+        } while (0)
+
+        for (; i + 16 <= count; i += 16) {
+                __m512 y1, y2, y3, y4, v1, v2, v3, v4;
+                SPLIT_AVX512(planes->Y + top, y1, y2);
+                SPLIT_AVX512(planes->Y + bottom, y3, y4);
+
+                __m512 a = _mm512_add_ps(_mm512_add_ps(_mm512_add_ps(y4, y3),
+                                                       y2), y1);
+                __m512 b = _mm512_sub_ps(_mm512_sub_ps(_mm512_add_ps(y4, y3),
+                                                       y2), y1);
+                __m512 c = _mm512_sub_ps(_mm512_add_ps(_mm512_sub_ps(y4, y3),
+                                                       y2), y1);
+                __m512 d = _mm512_add_ps(_mm512_sub_ps(_mm512_sub_ps(y4, y3),
+                                                       y2), y1);
+
+                a = _mm512_mul_ps(_mm512_div_ps(a, quarter),
+                                  _mm512_set1_ps(511.0f));
+                _mm512_storeu_si512(blocks->fields.a + i,
+                                    _mm512_cvtps_epi32(roundAwayAvx512(a)));
+                _mm512_storeu_si512(blocks->fields.b + i, quantizeDctAvx512(
+                                            _mm512_div_ps(b, quarter)));
+                _mm512_storeu_si512(blocks->fields.c + i, quantizeDctAvx512(
+                                            _mm512_div_ps(c, quarter)));
+                _mm512_storeu_si512(blocks->fields.d + i, quantizeDctAvx512(
+                                            _mm512_div_ps(d, quarter)));
+
+                SPLIT_AVX512(planes->Pb + top, v1, v2);
+                SPLIT_AVX512(planes->Pb + bottom, v3, v4);
+                _mm512_storeu_ps(blocks->pbAverage + i,
+                                 averageAvx512(v1, v2, v3, v4));
+                SPLIT_AVX512(planes->Pr + top, v1, v2);
+                SPLIT_AVX512(planes->Pr + bottom, v3, v4);
+                _mm512_storeu_ps(blocks->prAverage + i,
+                                 averageAvx512(v1, v2, v3, v4));
+        }
+#undef SPLIT_AVX512
+
+        return i;
+}
+
+#endif
+
+/********** BlockKernels_quantize ********
+ *
+ *  Quantizes as many of a run of blocks as the widest kernel can
+ *
+ * Parameters:
+ *      CvPlanes_T planes: the planes holding the blocks
+ *      unsigned col, row: the top left pixel of the first block
+ *      unsigned count:    the number of blocks, side by side
+ *      struct quantizedBlocks *blocks: where the values of each go
+ *
+ * Return:
+ *      The number of leading blocks quantized, which the caller need not
+ *      pack itself
+ *
+ * Expects
+ *      planes and blocks to not be null
+ *      count to be at most BLOCK_BATCH
+ *      the blocks to lie inside the planes
+ *
+ * Notes:
+ *      Will CRE if planes or blocks is null or count is too large
+ *      Returns 0 when the simdLevel is scalar
+ *
+ ************************/
+unsigned BlockKernels_quantize(CvPlanes_T planes, unsigned col, unsigned row,
+                               unsigned count,
+                               struct quantizedBlocks *blocks)
+{
+        assert(planes != NULL);
+        assert(blocks != NULL);
+        assert(count <= BLOCK_BATCH);
+
+        switch (SimdLevel_get()) {
+#ifdef SIMD_X86
+        case SIMD_AVX512:
+                return quantizeAvx512(planes, col, row, count, blocks);
+        case SIMD_AVX2:
+                return quantizeAvx2(planes, col, row, count, blocks);
+        case SIMD_SSE41:
+                return quantizeSse(planes, col, row, count, blocks);
+#endif
+        default:
+                (void) col;
+                (void) row;
+                return 0;
+        }
+}
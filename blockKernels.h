@@ -0,0 +1,40 @@
+/*
+ *      blockKernels.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the block kernels, which run
+ *      the discrete cosine transform, the clamp and quantization of its
+ *      coefficients, and the chroma averaging on a run of 2x2 blocks of
+ *      component video planes, several blocks at a time. They give exactly
+ *      the values packPlanesBlock computes for each block, short of
+ *      turning the chroma averages into indices and bitpacking.
+ */
+
+#ifndef BLOCK_KERNELS
+#define BLOCK_KERNELS
+
+#include <stdint.h>
+#include "cvPlanes.h"
+#include "wordKernels.h"
+
+/* The most blocks quantized in one call, one batch of codewords */
+#define BLOCK_BATCH WORD_BATCH
+
+/* the quantized values of a run of blocks, one array per value */
+struct quantizedBlocks {
+        struct wordFields fields;     /* a times 511, and the clamped b, c
+                                         and d times 50; pb and pr are left
+                                         for the caller to index */
+        float pbAverage[BLOCK_BATCH]; /* average Pb of the block */
+        float prAverage[BLOCK_BATCH]; /* average Pr of the block */
+};
+
+/* quantizes the count blocks whose top left pixels are (col, row),
+   (col + 2, row), ..., and returns how many leading blocks were done:
+   a multiple of the vector width, or 0 if the CPU has no kernel */
+unsigned BlockKernels_quantize(CvPlanes_T planes, unsigned col, unsigned row,
+                               unsigned count,
+                               struct quantizedBlocks *blocks);
+
+#endif
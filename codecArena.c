@@ -0,0 +1,295 @@
+/*
+ *      codecArena.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation of CodecArena and ArenaPool.
+ *      Each buffer of an arena is one aligned allocation that only grows,
+ *      by a quarter more than it is asked for so that a run of images of
+ *      about the same size settles on one allocation. The pool is a stack
+ *      of idle arenas behind a mutex; it makes a new arena only when every
+ *      arena it has made is in use.
+ */
+
+/* posix_memalign is POSIX, not C99 */
+#define _POSIX_C_SOURCE 200112L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include "assert.h"
+
+#include "codecArena.h"
+
+/* Every buffer starts on, and is a multiple of, this many bytes */
+static const size_t BUFFER_ALIGNMENT = 64;
+
+/* CodecArena_T struct that stores the buffers and the planes laid out
+   over one of them */
+struct CodecArena_T {
+        void *buffers[ARENA_BUFFERS];
+        size_t capacity[ARENA_BUFFERS];
+        struct CvPlanes_T planes;
+        CodecArena_T next;      /* the next idle arena in a pool */
+};
+
+/* ArenaPool_T struct that stores the arenas no task is using */
+struct ArenaPool_T {
+        pthread_mutex_t lock;   /* protects idle */
+        CodecArena_T idle;
+};
+
+/********** CodecArena_new ********
+ *
+ *  Makes an arena whose buffers are all empty
+ *
+ * Parameters:
+ *      none
+ *
+ * Return:
+ *      A new CodecArena_T
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails
+ *      The caller frees the arena with CodecArena_free
+ *
+ ************************/
+CodecArena_T CodecArena_new(void)
+{
+        CodecArena_T arena = calloc(1, sizeof(*arena));
+        assert(arena != NULL);
+        return arena;
+}
+
+/********** CodecArena_free ********
+ *
+ *  Frees an arena and every buffer it holds
+ *
+ * Parameters:
+ *      CodecArena_T *arena: a pointer to the arena to free
+ *
+ * Return:
+ *      none
+ *
+ * Expects
+ *      arena and *arena to not be null
+ *
+ * Notes:
+ *      Will CRE if arena or *arena is null
+ *      Sets *arena to NULL
+ *
+ ************************/
+void CodecArena_free(CodecArena_T *arena)
+{
+        assert(arena != NULL && *arena != NULL);
+
+        for (unsigned i = 0; i < ARENA_BUFFERS; i++) {
+                free((*arena)->buffers[i]);
+        }
+        free(*arena);
+        *arena = NULL;
+}
+
+/********** CodecArena_buffer ********
+ *
+ *  Gives room in one of the arena's buffers, making it if it does not 
+ *  exist yet and growing it if it is too small
+ *
+ * Parameters:
+ *      CodecArena_T arena:     the arena
+ *      enum arenaBuffer which: the buffer to use
+ *      size_t bytes:           how much room is needed
+ *
+ * Return:
+ *      64-byte aligned room for at least bytes bytes, or NULL if the buffer
+ *      cannot grow that large
+ *
+ * Expects
+ *      arena to not be null
+ *      which to name a buffer
+ *
+ * Notes:
+ *      Will CRE if arena is null or which is out of range
+ *      The contents are not kept when the buffer grows
+ *      A buffer that cannot grow is left as it was, so the arena can still
+ *      be used for smaller images
+ *
+ ************************/
+void *CodecArena_buffer(CodecArena_T arena, enum arenaBuffer which,
+                        size_t bytes)
+{
+        assert(arena != NULL);
+        assert(which < ARENA_BUFFERS);
+
+        if (arena->buffers[which] == NULL || 
+            bytes > arena->capacity[which]) {
+                size_t capacity = bytes + bytes / 4 + BUFFER_ALIGNMENT;
+                capacity -= capacity % BUFFER_ALIGNMENT;
+
+                /* capacity wraps around if bytes is absurdly large */
+                void *buffer = NULL;
+                if (capacity < bytes || posix_memalign(&buffer, 
+                                        BUFFER_ALIGNMENT, capacity) != 0) {
+                        return NULL;
+                }
+                free(arena->buffers[which]);
+                arena->buffers[which] = buffer;
+                arena->capacity[which] = capacity;
+        }
+
+        return arena->buffers[which];
+}
+
+/********** CodecArena_planes ********
+ *
+ *  Gives the arena's planes, laid out for an image of the given size
+ *
+ * Parameters:
+ *      CodecArena_T arena: the arena
+ *      unsigned width:     the width of the image in pixels
+ *      unsigned height:    the height of the image in pixels
+ *
+ * Return:
+ *      The planes, whose values are uninitialized
+ *
+ * Expects
+ *      arena to not be null
+ *
+ * Notes:
+ *      Will CRE if arena is null or memory allocation fails
+ *      The planes use the ARENA_PLANES buffer and are only valid until it
+ *      is asked for again
+ *
+ ************************/
+CvPlanes_T CodecArena_planes(CodecArena_T arena, unsigned width,
+                             unsigned height)
+{
+        assert(arena != NULL);
+
+        void *values = CodecArena_buffer(arena, ARENA_PLANES,
+                                         CvPlanes_bytes(width, height));
+        assert(values != NULL);
+        CvPlanes_init(&arena->planes, width, height, values);
+        return &arena->planes;
+}
+
+/********** ArenaPool_new ********
+ *
+ *  Makes a pool with no arenas in it
+ *
+ * Parameters:
+ *      none
+ *
+ * Return:
+ *      A new ArenaPool_T
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails
+ *      The caller frees the pool with ArenaPool_free
+ *
+ ************************/
+ArenaPool_T ArenaPool_new(void)
+{
+        ArenaPool_T pool = malloc(sizeof(*pool));
+        assert(pool != NULL);
+        pthread_mutex_init(&pool->lock, NULL);
+        pool->idle = NULL;
+        return pool;
+}
+
+/********** ArenaPool_free ********
+ *
+ *  Frees a pool and every arena that has been given back to it
+ *
+ * Parameters:
+ *      ArenaPool_T *pool: a pointer to the pool to free
+ *
+ * Return:
+ *      none
+ *
+ * Expects
+ *      pool and *pool to not be null
+ *      every arena taken from the pool to have been given back
+ *
+ * Notes:
+ *      Will CRE if pool or *pool is null
+ *      Sets *pool to NULL
+ *
+ ************************/
+void ArenaPool_free(ArenaPool_T *pool)
+{
+        assert(pool != NULL && *pool != NULL);
+
+        CodecArena_T arena = (*pool)->idle;
+        while (arena != NULL) {
+                CodecArena_T next = arena->next;
+                CodecArena_free(&arena);
+                arena = next;
+        }
+        pthread_mutex_destroy(&(*pool)->lock);
+        free(*pool);
+        *pool = NULL;
+}
+
+/********** ArenaPool_take ********
+ *
+ *  Takes an idle arena out of the pool, or makes one if none is idle
+ *
+ * Parameters:
+ *      ArenaPool_T pool: the pool
+ *
+ * Return:
+ *      An arena no one else is using, with whatever buffers it last had
+ *
+ * Expects
+ *      pool to not be null
+ *
+ * Notes:
+ *      Will CRE if pool is null or memory allocation fails
+ *      The arena goes back with ArenaPool_give
+ *
+ ************************/
+CodecArena_T ArenaPool_take(ArenaPool_T pool)
+{
+        assert(pool != NULL);
+
+        pthread_mutex_lock(&pool->lock);
+        CodecArena_T arena = pool->idle;
+        if (arena != NULL) {
+                pool->idle = arena->next;
+        }
+        pthread_mutex_unlock(&pool->lock);
+
+        if (arena == NULL) {
+                arena = CodecArena_new();
+        }
+        return arena;
+}
+
+/********** ArenaPool_give ********
+ *
+ *  Gives an arena back to the pool for the next task to take
+ *
+ * Parameters:
+ *      ArenaPool_T pool:   the pool
+ *      CodecArena_T arena: the arena, which the caller no longer uses
+ *
+ * Return:
+ *      none
+ *
+ * Expects
+ *      pool and arena to not be null
+ *
+ * Notes:
+ *      Will CRE if pool or arena is null
+ *
+ ************************/
+void ArenaPool_give(ArenaPool_T pool, CodecArena_T arena)
+{
+        assert(pool != NULL);
+        assert(arena != NULL);
+
+        pthread_mutex_lock(&pool->lock);
+        arena->next = pool->idle;
+        pool->idle = arena;
+        pthread_mutex_unlock(&pool->lock);
+}
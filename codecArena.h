@@ -0,0 +1,54 @@
+/*
+ *      codecArena.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for CodecArena, which owns the
+ *      working buffers of a compression or decompression: the component
+ *      video planes and the rows of pixels and codewords. A buffer is only
+ *      reallocated when an image needs more than it holds, so an arena
+ *      used for image after image stops allocating once it has seen the
+ *      largest one. An ArenaPool hands arenas out to the tasks of a batch
+ *      and takes them back, so each is reused by the files that follow.
+ */
+
+#ifndef CODEC_ARENA
+#define CODEC_ARENA
+
+#include <stddef.h>
+#include "cvPlanes.h"
+
+typedef struct CodecArena_T *CodecArena_T;
+typedef struct ArenaPool_T *ArenaPool_T;
+
+/* the buffers of an arena; each one can be in use at the same time */
+enum arenaBuffer {
+        ARENA_PLANES,     /* the storage of the arena's planes */
+        ARENA_TOP_ROW,    /* a row of pixels */
+        ARENA_BOTTOM_ROW, /* the row of pixels below it */
+        ARENA_WORD_ROW,   /* a row of codewords */
+        ARENA_BUFFERS
+};
+
+CodecArena_T CodecArena_new(void);
+void CodecArena_free(CodecArena_T *arena);
+
+/* returns 64-byte aligned room for at least bytes bytes, whose contents
+   are undefined, valid until the same buffer is asked for again; NULL if
+   the buffer cannot grow that large */
+void *CodecArena_buffer(CodecArena_T arena, enum arenaBuffer which,
+                        size_t bytes);
+/* returns the arena's planes, resized to width by height, which belong to
+   the arena and must not be given to CvPlanes_free */
+CvPlanes_T CodecArena_planes(CodecArena_T arena, unsigned width,
+                             unsigned height);
+
+ArenaPool_T ArenaPool_new(void);
+/* frees the pool and every arena given back to it */
+void ArenaPool_free(ArenaPool_T *pool);
+
+/* take and give may be called from any thread */
+CodecArena_T ArenaPool_take(ArenaPool_T pool);
+void ArenaPool_give(ArenaPool_T pool, CodecArena_T arena);
+
+#endif
@@ -0,0 +1,25 @@
+/*
+ *      codecModes.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the alternative compression and
+ *      decompression modes that 40image can select on the command line. 
+ *      Every mode reads the same input and writes output byte-for-byte
+ *      identical to compress40 and decompress40.
+ */
+
+#ifndef CODEC_MODES
+#define CODEC_MODES
+
+#include <stdio.h>
+
+/* Fused mode: one pass over the image with no intermediate arrays */
+void compress40Fused(FILE *input);
+void decompress40Fused(FILE *input);
+
+/* Stream mode: reads and writes a few rows at a time, in O(width) memory */
+void compress40Stream(FILE *input);
+void decompress40Stream(FILE *input);
+
+#endif
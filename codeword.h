@@ -0,0 +1,88 @@
+/*
+ *      codeword.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the schema of the 32-bit codeword: the name,
+ *      width, lsb and signedness of each of its fields, listed once.
+ *      Everything that packs or unpacks codewords is generated from the
+ *      list, so every width and shift is a constant the compiler folds in.
+ *      The layout is fixed when the program is built: -DCODEWORD_FORMAT=n
+ *      builds with layout n instead. The format number in the compressed
+ *      header only records which layout a file was written with, so that a
+ *      reader built with another layout rejects the file instead of 
+ *      misreading it; it does not select a layout at run time.
+ */
+
+#ifndef CODEWORD_H
+#define CODEWORD_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "bitpackInline.h"
+
+#ifndef CODEWORD_FORMAT
+#define CODEWORD_FORMAT 2
+#endif
+
+/* CODEWORD_FIELDS(FIELD) expands FIELD(name, width, lsb, SIGNED or
+   UNSIGNED) once for each field, from the most significant down */
+#if CODEWORD_FORMAT == 2
+#define CODEWORD_FIELDS(FIELD) \
+        FIELD(a,  9, 23, UNSIGNED) \
+        FIELD(b,  5, 18, SIGNED) \
+        FIELD(c,  5, 13, SIGNED) \
+        FIELD(d,  5,  8, SIGNED) \
+        FIELD(pb, 4,  4, UNSIGNED) \
+        FIELD(pr, 4,  0, UNSIGNED)
+#else
+#error "no codeword layout for this CODEWORD_FORMAT"
+#endif
+
+/* the type of a field's value, and whether it is signed */
+#define CODEWORD_TYPE_UNSIGNED uint32_t
+#define CODEWORD_TYPE_SIGNED int32_t
+#define CODEWORD_IS_SIGNED_UNSIGNED false
+#define CODEWORD_IS_SIGNED_SIGNED true
+
+/* the number of fields in the codeword, a constant expression */
+#define CODEWORD_COUNT_FIELD(name, width, lsb, kind) + 1
+#define CODEWORD_FIELD_COUNT (0 CODEWORD_FIELDS(CODEWORD_COUNT_FIELD))
+
+/* the unchecked inline Bitpack functions for each kind of field */
+#define CODEWORD_GET_UNSIGNED BitpackInline_getu
+#define CODEWORD_GET_SIGNED BitpackInline_gets
+#define CODEWORD_NEW_UNSIGNED BitpackInline_newu
+#define CODEWORD_NEW_SIGNED BitpackInline_news
+
+/* Codeword_<name>(word) returns the field name of word */
+#define CODEWORD_GETTER(name, width, lsb, kind) \
+static inline CODEWORD_TYPE_##kind Codeword_##name(uint32_t word) \
+{ \
+        return CODEWORD_GET_##kind(word, width, lsb); \
+}
+CODEWORD_FIELDS(CODEWORD_GETTER)
+#undef CODEWORD_GETTER
+
+/* Codeword_fits_<name>(value) tells whether value fits in the field, and
+   Codeword_set_<name>(word, value) returns word with the field replaced by
+   the low bits of value, without checking that it fits */
+#define CODEWORD_MIN_UNSIGNED(width) 0
+#define CODEWORD_MAX_UNSIGNED(width) (((int64_t)1 << (width)) - 1)
+#define CODEWORD_MIN_SIGNED(width) (-((int64_t)1 << ((width) - 1)))
+#define CODEWORD_MAX_SIGNED(width) (((int64_t)1 << ((width) - 1)) - 1)
+
+#define CODEWORD_SETTER(name, width, lsb, kind) \
+static inline bool Codeword_fits_##name(int64_t value) \
+{ \
+        return value >= CODEWORD_MIN_##kind(width) && \
+               value <= CODEWORD_MAX_##kind(width); \
+} \
+static inline uint32_t Codeword_set_##name(uint32_t word, int64_t value) \
+{ \
+        return CODEWORD_NEW_##kind(word, width, lsb, value); \
+}
+CODEWORD_FIELDS(CODEWORD_SETTER)
+#undef CODEWORD_SETTER
+
+#endif
@@ -0,0 +1,480 @@
+/*
+ *      colorKernels.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation of the color kernels.
+ *      calculateCv and calculateRgb do their sums in double, since their
+ *      coefficients are double constants, and round the result to float,
+ *      so the vector kernels widen each float vector to two double vectors,
+ *      add the products in the same order, and narrow back. The division
+ *      by the denominator, the clamp to [0, 1], and the final scaling stay
+ *      in float, as they are in C. Without fused multiply-adds every lane
+ *      rounds exactly as the scalar code does.
+ */
+
+#include "assert.h"
+
+#include "pnm.h"
+#include "componentVideo.h"
+#include "transformPixels.h"
+#include "simdLevel.h"
+#include "colorKernels.h"
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+#endif
+
+/* The kernels for one instruction set */
+struct colorKernels {
+        void (*rgbToCv)(Pnm_rgb pixels, unsigned count,
+                        unsigned denominator,
+                        float *Y, float *Pb, float *Pr);
+        void (*cvToRgb)(const float *Y, const float *Pb, const float *Pr,
+                        unsigned count, unsigned denominator,
+                        Pnm_rgb pixels);
+};
+
+static void rgbToCvScalar(Pnm_rgb pixels, unsigned count,
+                          unsigned denominator,
+                          float *Y, float *Pb, float *Pr);
+static void cvToRgbScalar(const float *Y, const float *Pb, const float *Pr,
+                          unsigned count, unsigned denominator,
+                          Pnm_rgb pixels);
+
+/* Coefficients of each output as ((k1 * x1) + (k2 * x2)) + (k3 * x3).
+   Subtracting a product is the same as adding it with its sign flipped,
+   and multiplying by 1.0 changes nothing, so this is exactly the sums in
+   calculateCv and calculateRgb */
+static const double Y_OF_RGB[3] = { 0.299, 0.587, 0.114 };
+static const double PB_OF_RGB[3] = { -0.168736, -0.331264, 0.5 };
+static const double PR_OF_RGB[3] = { 0.5, -0.418688, -0.081312 };
+static const double R_OF_CV[3] = { 1.0, 0.0, 1.402 };
+static const double G_OF_CV[3] = { 1.0, -0.344136, -0.714136 };
+static const double B_OF_CV[3] = { 1.0, 1.772, 0.0 };
+
+#ifdef SIMD_X86
+
+/****************************************************************
+*                                                               *
+*                         SSE4.1 Kernels                        *
+*                                                               *
+*****************************************************************/
+
+/* ((k[0] * x1) + (k[1] * x2)) + (k[2] * x3) on two doubles */
+SIMD_TARGET_SSE41
+static inline __m128d mixHalfSse(__m128d x1, __m128d x2, __m128d x3,
+                                 const double *k)
+{
+        __m128d sum = _mm_add_pd(_mm_mul_pd(_mm_set1_pd(k[0]), x1),
+                                 _mm_mul_pd(_mm_set1_pd(k[1]), x2));
+        return _mm_add_pd(sum, _mm_mul_pd(_mm_set1_pd(k[2]), x3));
+}
+
+/* the mix of four floats, summed in double and rounded back to float */
+SIMD_TARGET_SSE41
+static inline __m128 mixSse(__m128 x1, __m128 x2, __m128 x3,
+                            const double *k)
+{
+        __m128d low = mixHalfSse(_mm_cvtps_pd(x1), _mm_cvtps_pd(x2),
+                                 _mm_cvtps_pd(x3), k);
+        __m128d high = mixHalfSse(_mm_cvtps_pd(_mm_movehl_ps(x1, x1)),
+                                  _mm_cvtps_pd(_mm_movehl_ps(x2, x2)),
+                                  _mm_cvtps_pd(_mm_movehl_ps(x3, x3)), k);
+        return _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high));
+}
+
+SIMD_TARGET_SSE41
+static void rgbToCvSse(Pnm_rgb pixels, unsigned count,
+                       unsigned denominator,
+                       float *Y, float *Pb, float *Pr)
+{
+        __m128 scale = _mm_set1_ps((float)denominator);
+        unsigned i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+                Pnm_rgb p = pixels + i;
+                __m128i red = _mm_setr_epi32(p[0].red, p[1].red,
+                                             p[2].red, p[3].red);
+                __m128i green = _mm_setr_epi32(p[0].green, p[1].green,
+                                               p[2].green, p[3].green);
+                __m128i blue = _mm_setr_epi32(p[0].blue, p[1].blue,
+                                              p[2].blue, p[3].blue);
+
+                __m128 r = _mm_div_ps(_mm_cvtepi32_ps(red), scale);
+                __m128 g = _mm_div_ps(_mm_cvtepi32_ps(green), scale);
+                __m128 b = _mm_div_ps(_mm_cvtepi32_ps(blue), scale);
+
+                _mm_storeu_ps(Y + i, mixSse(r, g, b, Y_OF_RGB));
+                _mm_storeu_ps(Pb + i, mixSse(r, g, b, PB_OF_RGB));
+                _mm_storeu_ps(Pr + i, mixSse(r, g, b, PR_OF_RGB));
+        }
+
+        rgbToCvScalar(pixels + i, count - i, denominator,
+                      Y + i, Pb + i, Pr + i);
+}
+
+/* clamps four floats to [0, 1] and scales them to integers */
+SIMD_TARGET_SSE41
+static inline __m128i scaleSse(__m128 channel, __m128 scale)
+{
+        channel = _mm_min_ps(_mm_max_ps(channel, _mm_setzero_ps()),
+                             _mm_set1_ps(1.0f));
+        return _mm_cvttps_epi32(_mm_mul_ps(channel, scale));
+}
+
+SIMD_TARGET_SSE41
+static void cvToRgbSse(const float *Y, const float *Pb,
+                       const float *Pr, unsigned count,
+                       unsigned denominator, Pnm_rgb pixels)
+{
+        __m128 scale = _mm_set1_ps((float)denominator);
+        unsigned i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+                __m128 y = _mm_loadu_ps(Y + i);
+                __m128 pb = _mm_loadu_ps(Pb + i);
+                __m128 pr = _mm_loadu_ps(Pr + i);
+
+                int red[4], green[4], blue[4];
+                _mm_storeu_si128((__m128i *)red,
+                                 scaleSse(mixSse(y, pb, pr, R_OF_CV), scale));
+                _mm_storeu_si128((__m128i *)green,
+                                 scaleSse(mixSse(y, pb, pr, G_OF_CV), scale));
+                _mm_storeu_si128((__m128i *)blue,
+                                 scaleSse(mixSse(y, pb, pr, B_OF_CV), scale));
+
+                for (unsigned lane = 0; lane < 4; lane++) {
+                        pixels[i + lane].red = red[lane];
+                        pixels[i + lane].green = green[lane];
+                        pixels[i + lane].blue = blue[lane];
+                }
+        }
+
+        cvToRgbScalar(Y + i, Pb + i, Pr + i, count - i, denominator,
+                      pixels + i);
+}
+
+/****************************************************************
+*                                                               *
+*                          AVX2 Kernels                         *
+*                                                               *
+*****************************************************************/
+
+/* ((k[0] * x1) + (k[1] * x2)) + (k[2] * x3) on four doubles */
+SIMD_TARGET_AVX2
+static inline __m256d mixHalfAvx2(__m256d x1, __m256d x2, __m256d x3,
+                                  const double *k)
+{
+        __m256d sum = _mm256_add_pd(_mm256_mul_pd(_mm256_set1_pd(k[0]), x1),
+                                    _mm256_mul_pd(_mm256_set1_pd(k[1]), x2));
+        return _mm256_add_pd(sum, _mm256_mul_pd(_mm256_set1_pd(k[2]), x3));
+}
+
+/* the mix of eight floats, summed in double and rounded back to float */
+SIMD_TARGET_AVX2
+static inline __m256 mixAvx2(__m256 x1, __m256 x2, __m256 x3,
+                             const double *k)
+{
+        __m256d low = mixHalfAvx2(
+                _mm256_cvtps_pd(_mm256_castps256_ps128(x1)),
+                _mm256_cvtps_pd(_mm256_castps256_ps128(x2)),
+                _mm256_cvtps_pd(_mm256_castps256_ps128(x3)), k);
+        __m256d high = mixHalfAvx2(
+                _mm256_cvtps_pd(_mm256_extractf128_ps(x1, 1)),
+                _mm256_cvtps_pd(_mm256_extractf128_ps(x2, 1)),
+                _mm256_cvtps_pd(_mm256_extractf128_ps(x3, 1)), k);
+        return _mm256_insertf128_ps(
+                _mm256_castps128_ps256(_mm256_cvtpd_ps(low)),
+                _mm256_cvtpd_ps(high), 1);
+}
+
+SIMD_TARGET_AVX2
+static void rgbToCvAvx2(Pnm_rgb pixels, unsigned count,
+                        unsigned denominator,
+                        float *Y, float *Pb, float *Pr)
+{
+        __m256 scale = _mm256_set1_ps((float)denominator);
+        __m256i channel = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+        unsigned i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+                const int *first = (const int *)&pixels[i];
+                __m256 r = _mm256_div_ps(_mm256_cvtepi32_ps(
+                        _mm256_i32gather_epi32(first, channel, 4)), scale);
+                __m256 g = _mm256_div_ps(_mm256_cvtepi32_ps(
+                        _mm256_i32gather_epi32(first + 1, channel, 4)), scale);
+                __m256 b = _mm256_div_ps(_mm256_cvtepi32_ps(
+                        _mm256_i32gather_epi32(first + 2, channel, 4)), scale);
+
+                _mm256_storeu_ps(Y + i, mixAvx2(r, g, b, Y_OF_RGB));
+                _mm256_storeu_ps(Pb + i, mixAvx2(r, g, b, PB_OF_RGB));
+                _mm256_storeu_ps(Pr + i, mixAvx2(r, g, b, PR_OF_RGB));
+        }
+
+        rgbToCvScalar(pixels + i, count - i, denominator,
+                      Y + i, Pb + i, Pr + i);
+}
+
+/* clamps eight floats to [0, 1] and scales them to integers */
+SIMD_TARGET_AVX2
+static inline __m256i scaleAvx2(__m256 channel, __m256 scale)
+{
+        channel = _mm256_min_ps(_mm256_max_ps(channel, _mm256_setzero_ps()),
+                                _mm256_set1_ps(1.0f));
+        return _mm256_cvttps_epi32(_mm256_mul_ps(channel, scale));
+}
+
+SIMD_TARGET_AVX2
+static void cvToRgbAvx2(const float *Y, const float *Pb,
+                        const float *Pr, unsigned count,
+                        unsigned denominator, Pnm_rgb pixels)
+{
+        __m256 scale = _mm256_set1_ps((float)denominator);
+        unsigned i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+                __m256 y = _mm256_loadu_ps(Y + i);
+                __m256 pb = _mm256_loadu_ps(Pb + i);
+                __m256 pr = _mm256_loadu_ps(Pr + i);
+
+                int red[8], green[8], blue[8];
+                _mm256_storeu_si256((__m256i *)red,
+                        scaleAvx2(mixAvx2(y, pb, pr, R_OF_CV), scale));
+                _mm256_storeu_si256((__m256i *)green,
+                        scaleAvx2(mixAvx2(y, pb, pr, G_OF_CV), scale));
+                _mm256_storeu_si256((__m256i *)blue,
+                        scaleAvx2(mixAvx2(y, pb, pr, B_OF_CV), scale));
+
+                for (unsigned lane = 0; lane < 8; lane++) {
+                        pixels[i + lane].red = red[lane];
+                        pixels[i + lane].green = green[lane];
+                        pixels[i + lane].blue = blue[lane];
+                }
+        }
+
+        cvToRgbScalar(Y + i, Pb + i, Pr + i, count - i, denominator,
+                      pixels + i);
+}
+
+/****************************************************************
+*                                                               *
+*                        AVX-512 Kernels                        *
+*                                                               *
+*****************************************************************/
+
+/* ((k[0] * x1) + (k[1] * x2)) + (k[2] * x3) on eight doubles */
+SIMD_TARGET_AVX512
+static inline __m512d mixHalfAvx512(__m512d x1, __m512d x2,
+                                    __m512d x3, const double *k)
+{
+        __m512d sum = _mm512_add_pd(_mm512_mul_pd(_mm512_set1_pd(k[0]), x1),
+                                    _mm512_mul_pd(_mm512_set1_pd(k[1]), x2));
+        return _mm512_add_pd(sum, _mm512_mul_pd(_mm512_set1_pd(k[2]), x3));
+}
+
+/* the upper eight of sixteen floats, widened to doubles */
+SIMD_TARGET_AVX512
+static inline __m512d upperAvx512(__m512 x)
+{
+        return _mm512_cvtps_pd(_mm256_castpd_ps(
+                _mm512_extractf64x4_pd(_mm512_castps_pd(x), 1)));
+}
+
+/* the mix of sixteen floats, summed in double and rounded back to float */
+SIMD_TARGET_AVX512
+static inline __m512 mixAvx512(__m512 x1, __m512 x2, __m512 x3,
+                               const double *k)
+{
+        __m512d low = mixHalfAvx512(
+                _mm512_cvtps_pd(_mm512_castps512_ps256(x1)),
+                _mm512_cvtps_pd(_mm512_castps512_ps256(x2)),
+                _mm512_cvtps_pd(_mm512_castps512_ps256(x3)), k);
+        __m512d high = mixHalfAvx512(upperAvx512(x1), upperAvx512(x2),
+                                     upperAvx512(x3), k);
+        __m512d joined = _mm512_insertf64x4(
+                _mm512_castpd256_pd512(_mm256_castps_pd(
+                        _mm512_cvtpd_ps(low))),
+                _mm256_castps_pd(_mm512_cvtpd_ps(high)), 1);
+        return _mm512_castpd_ps(joined);
+}
+
+SIMD_TARGET_AVX512
+static void rgbToCvAvx512(Pnm_rgb pixels, unsigned count,
+                          unsigned denominator,
+                          float *Y, float *Pb, float *Pr)
+{
+        __m512 scale = _mm512_set1_ps((float)denominator);
+        __m512i channel = _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21,
+                                            24, 27, 30, 33, 36, 39, 42, 45);
+        unsigned i = 0;
+
+        for (; i + 16 <= count; i += 16) {
+                const int *first = (const int *)&pixels[i];
+                __m512 r = _mm512_div_ps(_mm512_cvtepi32_ps(
+                        _mm512_i32gather_epi32(channel, first, 4)), scale);
+                __m512 g = _mm512_div_ps(_mm512_cvtepi32_ps(
+                        _mm512_i32gather_epi32(channel, first + 1, 4)),
+                        scale);
+                __m512 b = _mm512_div_ps(_mm512_cvtepi32_ps(
+                        _mm512_i32gather_epi32(channel, first + 2, 4)),
+                        scale);
+
+                _mm512_storeu_ps(Y + i, mixAvx512(r, g, b, Y_OF_RGB));
+                _mm512_storeu_ps(Pb + i, mixAvx512(r, g, b, PB_OF_RGB));
+                _mm512_storeu_ps(Pr + i, mixAvx512(r, g, b, PR_OF_RGB));
+        }
+
+        rgbToCvScalar(pixels + i, count - i, denominator,
+                      Y + i, Pb + i, Pr + i);
+}
+
+/* clamps sixteen floats to [0, 1] and scales them to integers */
+SIMD_TARGET_AVX512
+static inline __m512i scaleAvx512(__m512 channel, __m512 scale)
+{
+        channel = _mm512_min_ps(_mm512_max_ps(channel, _mm512_setzero_ps()),
+                                _mm512_set1_ps(1.0f));
+        return _mm512_cvttps_epi32(_mm512_mul_ps(channel, scale));
+}
+
+SIMD_TARGET_AVX512
+static void cvToRgbAvx512(const float *Y, const float *Pb,
+                          const float *Pr, unsigned count,
+                          unsigned denominator, Pnm_rgb pixels)
+{
+        __m512 scale = _mm512_set1_ps((float)denominator);
+        __m512i channel = _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21,
+                                            24, 27, 30, 33, 36, 39, 42, 45);
+        unsigned i = 0;
+
+        for (; i + 16 <= count; i += 16) {
+                __m512 y = _mm512_loadu_ps(Y + i);
+                __m512 pb = _mm512_loadu_ps(Pb + i);
+                __m512 pr = _mm512_loadu_ps(Pr + i);
+
+                /* scatter each channel straight into the pixel structs */
+                int *first = (int *)&pixels[i];
+                _mm512_i32scatter_epi32(first, channel,
+                        scaleAvx512(mixAvx512(y, pb, pr, R_OF_CV), scale), 4);
+                _mm512_i32scatter_epi32(first + 1, channel,
+                        scaleAvx512(mixAvx512(y, pb, pr, G_OF_CV), scale), 4);
+                _mm512_i32scatter_epi32(first + 2, channel,
+                        scaleAvx512(mixAvx512(y, pb, pr, B_OF_CV), scale), 4);
+        }
+
+        cvToRgbScalar(Y + i, Pb + i, Pr + i, count - i, denominator,
+                      pixels + i);
+}
+
+#endif
+
+/****************************************************************
+*                                                               *
+*                    Scalar Kernels and Entry Points            *
+*                                                               *
+*****************************************************************/
+
+/* the kernel set for each simdLevel */
+static const struct colorKernels KERNELS[] = {
+        { rgbToCvScalar, cvToRgbScalar },
+#ifdef SIMD_X86
+        { rgbToCvSse, cvToRgbSse },
+        { rgbToCvAvx2, cvToRgbAvx2 },
+        { rgbToCvAvx512, cvToRgbAvx512 },
+#endif
+};
+
+/********** ColorKernels_rgbToCv ********
+ *
+ *  Converts a run of RGB pixels to component video
+ *
+ * Parameters:
+ *      Pnm_rgb pixels:       the count pixels to convert
+ *      unsigned count:       the number of pixels
+ *      unsigned denominator: the denominator the pixels are scaled by
+ *      float *Y, *Pb, *Pr:   where the count values of each go
+ *
+ * Return:
+ *      none
+ *
+ * Expects
+ *      pixels, Y, Pb and Pr to not be null
+ *      every channel to be at most denominator, which is at most 65535
+ *
+ * Notes:
+ *      Will CRE if pixels, Y, Pb or Pr is null
+ *      Gives the same values as calculateCv on each pixel
+ *
+ ************************/
+void ColorKernels_rgbToCv(Pnm_rgb pixels, unsigned count,
+                          unsigned denominator,
+                          float *Y, float *Pb, float *Pr)
+{
+        assert(pixels != NULL);
+        assert(Y != NULL && Pb != NULL && Pr != NULL);
+
+        KERNELS[SimdLevel_get()].rgbToCv(pixels, count, denominator, Y, Pb, Pr);
+}
+
+/********** ColorKernels_cvToRgb ********
+ *
+ *  Converts a run of component video values to RGB pixels
+ *
+ * Parameters:
+ *      const float *Y, *Pb, *Pr: the count values of each to convert
+ *      unsigned count:           the number of pixels
+ *      unsigned denominator:     the denominator to scale the pixels by
+ *      Pnm_rgb pixels:           where the count pixels go
+ *
+ * Return:
+ *      none
+ *
+ * Expects
+ *      Y, Pb, Pr and pixels to not be null
+ *      denominator to be at most 65535
+ *
+ * Notes:
+ *      Will CRE if Y, Pb, Pr or pixels is null
+ *      Gives the same pixels as calculateRgb on each value
+ *
+ ************************/
+void ColorKernels_cvToRgb(const float *Y, const float *Pb, const float *Pr,
+                          unsigned count, unsigned denominator,
+                          Pnm_rgb pixels)
+{
+        assert(Y != NULL && Pb != NULL && Pr != NULL);
+        assert(pixels != NULL);
+
+        KERNELS[SimdLevel_get()].cvToRgb(Y, Pb, Pr, count, denominator, pixels);
+}
+
+/* the reference: calculateCv on one pixel at a time */
+static void rgbToCvScalar(Pnm_rgb pixels, unsigned count,
+                          unsigned denominator,
+                          float *Y, float *Pb, float *Pr)
+{
+        struct componentVideo cv;
+
+        for (unsigned i = 0; i < count; i++) {
+                calculateCv(&pixels[i], &cv, denominator);
+                Y[i] = cv.Y;
+                Pb[i] = cv.Pb;
+                Pr[i] = cv.Pr;
+        }
+}
+
+/* the reference: calculateRgb on one pixel at a time */
+static void cvToRgbScalar(const float *Y, const float *Pb, const float *Pr,
+                          unsigned count, unsigned denominator,
+                          Pnm_rgb pixels)
+{
+        struct componentVideo cv;
+
+        for (unsigned i = 0; i < count; i++) {
+                cv.Y = Y[i];
+                cv.Pb = Pb[i];
+                cv.Pr = Pr[i];
+                calculateRgb(&cv, &pixels[i], denominator);
+        }
+}
@@ -0,0 +1,26 @@
+/*
+ *      colorKernels.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the color kernels, which
+ *      convert a run of RGB pixels to component video planes, or a run of
+ *      component video back to RGB pixels, several pixels at a time. The
+ *      kernels for the simdLevel (AVX-512, AVX2, SSE4.1, or plain C) are
+ *      the ones run, and every kernel gives exactly the same results as 
+ *      calculateCv and calculateRgb.
+ */
+
+#ifndef COLOR_KERNELS
+#define COLOR_KERNELS
+
+#include "pnm.h"
+
+void ColorKernels_rgbToCv(Pnm_rgb pixels, unsigned count,
+                          unsigned denominator,
+                          float *Y, float *Pb, float *Pr);
+void ColorKernels_cvToRgb(const float *Y, const float *Pb, const float *Pr,
+                          unsigned count, unsigned denominator,
+                          Pnm_rgb pixels);
+
+#endif
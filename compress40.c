@@ -13,15 +13,24 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include "assert.h"
 #include "a2blocked.h"
 #include "a2plain.h"
 #include "pnm.h"
 
 #include "compress40.h"
+#include "codecModes.h"
 #include "readOrWrite.h"
 #include "transformPixels.h"
 #include "wordConversions.h"
+#include "fusedConversions.h"
+#include "ppmReader.h"
+#include "ppmImage.h"
+#include "ppmWriter.h"
+#include "codecArena.h"
+#include "a2methodsExt.h"
 
 /* Define our custom denominator as 255. We chose this because of the 
    maximum representation of a character, since we use putchar */
@@ -44,7 +53,8 @@ const unsigned CUSTOM_DENOMINATOR = 255;
  * 
  * Notes:
  *      Will CRE if the input file pointer is null
- *      Will CRE if Pnm_ppmread returns a null image
+ *      Will CRE if the image is malformed or ends early
+ *      Odd edges are cropped by ppmImage without a second copy
  *      
  ************************/
 extern void compress40(FILE *input)
@@ -55,19 +65,18 @@ extern void compress40(FILE *input)
         /* Use the UArray2 methods as default methods*/
         A2Methods_T methods = uarray2_methods_plain;
 
-        /* Read and Trim our input file! Note: if even it is returned back */
-        Pnm_ppm image = Pnm_ppmread(input, methods);
+        /* Read our input file, cropped to an even width and height */
+        PpmImage_T image = PpmImage_read(input);
         assert(image != NULL);
 
-        /* Trim the image if necessary */
-        Pnm_ppm newImage = trim(image, methods);
+        /* The arena holds the planes and every row buffer */
+        CodecArena_T arena = CodecArena_new();
 
-        /* Transform pixels from RGB to component video (Cv) */
-        A2Methods_UArray2 cvUArray2 = rgbToCv(newImage->pixels, 
-                                              methods, newImage->denominator);
+        /* Transform pixels from RGB to component video (Cv) planes */
+        CvPlanes_T planes = rgbToCv(image, arena);
 
         /* Convert component video to our a, b, c, d, Pb avg, Pr avg */
-        A2Methods_UArray2 bitpackedUArray2 = blocksToWords(cvUArray2, methods);
+        A2Methods_UArray2 bitpackedUArray2 = blocksToWords(planes, methods);
 
         unsigned width = methods->width(bitpackedUArray2) * 2;
         unsigned height = methods->height(bitpackedUArray2) * 2;
@@ -75,11 +84,121 @@ extern void compress40(FILE *input)
         /* Write the compressed words to disk */
         writeCompressed(bitpackedUArray2, methods, width, height);
         
-        /* Free the image allocated by trim and the UArray2 with the words */
-        Pnm_ppmfree(&newImage);
+        /* Free the image, the arena, and the UArray2 with the words */
+        PpmImage_free(&image);
+        CodecArena_free(&arena);
         methods->free(&bitpackedUArray2);
 }
 
+/********** compress40Fused ********
+ *
+ * Compresses a given .PPM image like compress40, but converts each pair of
+ * rows straight to codewords instead of building a component video array
+ *
+ * Parameters:
+ *      FILE *input: a pointer to the file to be compressed
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      FILE *input to not be null
+ *      File to be in correct PPM format
+ * 
+ * Notes:
+ *      Will CRE if the input file pointer is null
+ *      Will CRE if the image is malformed or ends early
+ *      Will CRE if memory allocation for the row buffers fails
+ *      
+ ************************/
+extern void compress40Fused(FILE *input)
+{
+        assert(input != NULL);
+
+        /* The image is read cropped to an even width and height */
+        PpmImage_T image = PpmImage_read(input);
+        assert(image != NULL);
+        unsigned width = image->width;
+        unsigned height = image->height;
+
+        /* Only two rows of pixels and one row of words are ever expanded */
+        Pnm_rgb top = malloc((width + 1) * sizeof(*top));
+        Pnm_rgb bottom = malloc((width + 1) * sizeof(*bottom));
+        uint32_t *words = malloc((width / 2 + 1) * sizeof(*words));
+        assert(top != NULL && bottom != NULL && words != NULL);
+
+        writeCompressedHeader(stdout, width, height);
+        for (unsigned row = 0; row < height; row += 2) {
+                PpmImage_row(image, row, top);
+                PpmImage_row(image, row + 1, bottom);
+                encodeRowPair(top, bottom, width, image->denominator, words);
+                writeWordRow(stdout, words, width / 2);
+        }
+
+        free(top);
+        free(bottom);
+        free(words);
+        PpmImage_free(&image);
+}
+
+/********** compress40Stream ********
+ *
+ * Compresses a given .PPM image like compress40, but reads it two rows at a
+ * time and writes each row of codewords as soon as it is made, so memory 
+ * use depends only on the width of the image
+ *
+ * Parameters:
+ *      FILE *input: a pointer to the file to be compressed
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      FILE *input to not be null
+ *      File to be in correct PPM format
+ * 
+ * Notes:
+ *      Will CRE if the input file pointer is null
+ *      Will CRE if the PPM header is malformed
+ *      Will CRE if the image ends before its last even row
+ *      Will CRE if memory allocation for the row buffers fails
+ *      An odd last row is never read and an odd last column is skipped,
+ *      the same way ppmImage drops them
+ *      
+ ************************/
+extern void compress40Stream(FILE *input)
+{
+        assert(input != NULL);
+
+        PpmReader_T reader = PpmReader_new(input);
+        assert(reader != NULL);
+        unsigned fullWidth = PpmReader_width(reader);
+        unsigned width = fullWidth - fullWidth % 2;
+        unsigned height = PpmReader_height(reader);
+        height -= height % 2;
+        unsigned denominator = PpmReader_denominator(reader);
+
+        /* Rows are read whole, then encoded without their odd last pixel */
+        Pnm_rgb top = malloc((fullWidth + 1) * sizeof(*top));
+        Pnm_rgb bottom = malloc((fullWidth + 1) * sizeof(*bottom));
+        uint32_t *words = malloc((width / 2 + 1) * sizeof(*words));
+        assert(top != NULL && bottom != NULL && words != NULL);
+
+        writeCompressedHeader(stdout, width, height);
+        for (unsigned row = 0; row < height; row += 2) {
+                bool read = PpmReader_readRow(reader, top) && 
+                            PpmReader_readRow(reader, bottom);
+                assert(read);
+                encodeRowPair(top, bottom, width, denominator, words);
+                writeWordRow(stdout, words, width / 2);
+        }
+
+        free(top);
+        free(bottom);
+        free(words);
+        PpmReader_free(&reader);
+}
+
 /********** decompress40 ********
  *
  * Decompress a given image using a decompression algorithm and prints
@@ -109,23 +228,135 @@ extern void decompress40(FILE *input)
         /* Read in the compressed words and store it in a UArray2 */
         A2Methods_UArray2 unpackedUArray2 = readCompressed(input, methods);
 
-        /* Convert the compressed words into 2x2 CV blocks */
-        unpackedUArray2 = wordsToBlocks(unpackedUArray2, methods);
+        /* Convert the compressed words into 2x2 blocks of CV planes, which
+           the arena holds along with every row buffer */
+        CodecArena_T arena = CodecArena_new();
+        CvPlanes_T planes = wordsToBlocks(unpackedUArray2, methods, arena);
 
-        /* Convert the 2x2 CV blocks to an RGB representation */
-        unpackedUArray2 = cvToRgb(unpackedUArray2, methods, 
-                                  CUSTOM_DENOMINATOR);
+        /* Convert the CV planes to an RGB representation */
+        unpackedUArray2 = cvToRgb(planes, methods, CUSTOM_DENOMINATOR);
+        CodecArena_free(&arena);
         
-        /* Construct a Pnm_ppm pixmap with the RGB represented data */
-        struct Pnm_ppm pixmap  = { .width = methods->width(unpackedUArray2),
-                                   .height = methods->height(unpackedUArray2),
-                                   .denominator = CUSTOM_DENOMINATOR, 
-                                   .pixels = unpackedUArray2, 
-                                   .methods = methods
-                                };
-        /* Write the RGB data stored by pixmap to disk */
-        Pnm_ppmwrite(stdout, &pixmap);
+        /* Write the RGB data to disk as a P6 image */
+        writeDecompressed(unpackedUArray2, methods, CUSTOM_DENOMINATOR);
 
         /* Free free unpackedUArray2 from the compressed file */
         methods->free(&unpackedUArray2);
-}
\ No newline at end of file
+}
+
+/********** decompress40Fused ********
+ *
+ * Decompresses a given image like decompress40, but decodes each row of 
+ * codewords straight into two rows of PPM bytes instead of building 
+ * component video and RGB arrays
+ *
+ * Parameters:
+ *      FILE *input: a pointer to the file to be decompressed
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      FILE *input to not be null
+ * 
+ * Notes:
+ *      Will CRE if the input file pointer is null
+ *      Will CRE if memory allocation for the row buffers fails
+ *      
+ ************************/
+extern void decompress40Fused(FILE *input)
+{
+        assert(input != NULL);
+        A2Methods_T methods = uarray2_methods_plain;
+
+        /* Read in the compressed words and store it in a UArray2 */
+        A2Methods_UArray2 wordsUArray2 = readCompressed(input, methods);
+        unsigned count = methods->width(wordsUArray2);
+        unsigned rows = methods->height(wordsUArray2);
+
+        /* Every codeword becomes 2 pixels, or 6 bytes, in each of 2 rows,
+           which are decoded straight into the writer's buffer */
+        uint32_t *buffer = malloc((count + 1) * sizeof(*buffer));
+        assert(buffer != NULL);
+
+        PpmWriter_T writer = PpmWriter_new(stdout, count * 2, rows * 2, 
+                                           CUSTOM_DENOMINATOR);
+        assert(writer != NULL);
+        for (unsigned row = 0; row < rows; row++) {
+                uint32_t *words = A2Methods_row(methods, wordsUArray2, row);
+                if (words == NULL) {
+                        A2Methods_getRow(methods, wordsUArray2, row, buffer);
+                        words = buffer;
+                }
+                unsigned char *top = PpmWriter_rows(writer, 2);
+                decodeWordRow(words, count, CUSTOM_DENOMINATOR, top, 
+                              top + 6 * count);
+        }
+
+        PpmWriter_free(&writer);
+        free(buffer);
+        methods->free(&wordsUArray2);
+}
+
+/********** decompress40Stream ********
+ *
+ * Decompresses a given image like decompress40, but writes the PPM header
+ * as soon as the compressed header is read and then writes two rows of 
+ * pixels for every row of codewords read, so memory use depends only on 
+ * the width of the image
+ *
+ * Parameters:
+ *      FILE *input: a pointer to the file to be decompressed
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      FILE *input to not be null
+ * 
+ * Notes:
+ *      Will CRE if the input file pointer is null
+ *      Will CRE if the compressed header is malformed
+ *      Will CRE if the file ends before its last codeword
+ *      Will CRE if memory allocation for the row buffers fails
+ *      Exits with an error once a row pair cannot be written
+ *      
+ ************************/
+extern void decompress40Stream(FILE *input)
+{
+        assert(input != NULL);
+
+        unsigned width, height;
+        readCompressedHeader(input, &width, &height);
+        unsigned count = width / 2;
+        unsigned rows = height / 2;
+        MappedInput_T mapped = MappedInput_new(input);
+
+        uint32_t *words = malloc((count + 1) * sizeof(*words));
+        assert(words != NULL);
+
+        /* Let a downstream reader see the header before any decoding */
+        PpmWriter_T writer = PpmWriter_new(stdout, count * 2, rows * 2, 
+                                           CUSTOM_DENOMINATOR);
+        assert(writer != NULL);
+        fflush(stdout);
+
+        for (unsigned row = 0; row < rows; row++) {
+                if (!takeWordRow(input, mapped, words, count)) {
+                        exitTruncated();
+                }
+                unsigned char *top = PpmWriter_rows(writer, 2);
+                decodeWordRow(words, count, CUSTOM_DENOMINATOR, top, 
+                              top + 6 * count);
+                /* hand the two rows on now rather than a chunk later */
+                if (!PpmWriter_flush(writer)) {
+                        exitWriteFailed();
+                }
+        }
+
+        PpmWriter_free(&writer);
+        if (mapped != NULL) {
+                MappedInput_free(&mapped);
+        }
+        free(words);
+}
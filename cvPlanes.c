@@ -0,0 +1,142 @@
+/*
+ *      cvPlanes.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation of CvPlanes. The three planes
+ *      share one aligned allocation, laid out one after another.
+ */
+
+/* posix_memalign is POSIX, not C99 */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include "assert.h"
+
+#include "cvPlanes.h"
+
+/* Every plane and every row starts on a multiple of this many bytes */
+static const size_t PLANE_ALIGNMENT = 64;
+
+/* the floats from one row to the next: rows are rounded up to whole 
+   64-byte lines, so every row, and so every plane, stays aligned */
+static size_t stride(unsigned width)
+{
+        size_t perLine = PLANE_ALIGNMENT / sizeof(float);
+        return (width + perLine - 1) / perLine * perLine;
+}
+
+/********** CvPlanes_new ********
+ *
+ *  Allocates the Y, Pb and Pr planes for an image of the given size
+ *
+ * Parameters:
+ *      unsigned width:  the width of the image in pixels
+ *      unsigned height: the height of the image in pixels
+ *
+ * Return:
+ *      The new planes, whose values are uninitialized
+ *
+ * Expects
+ *      none
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails
+ *      The caller frees the planes with CvPlanes_free
+ *
+ ************************/
+CvPlanes_T CvPlanes_new(unsigned width, unsigned height)
+{
+        CvPlanes_T planes = malloc(sizeof(*planes));
+        assert(planes != NULL);
+
+        void *values = NULL;
+        int failed = posix_memalign(&values, PLANE_ALIGNMENT,
+                                    CvPlanes_bytes(width, height));
+        assert(failed == 0);
+
+        CvPlanes_init(planes, width, height, values);
+        return planes;
+}
+
+/********** CvPlanes_bytes ********
+ *
+ *  Gives the size of the storage the planes of an image need
+ *
+ * Parameters:
+ *      unsigned width:  the width of the image in pixels
+ *      unsigned height: the height of the image in pixels
+ *
+ * Return:
+ *      The number of bytes CvPlanes_init lays the three planes out over
+ *
+ ************************/
+size_t CvPlanes_bytes(unsigned width, unsigned height)
+{
+        return 3 * stride(width) * height * sizeof(float) + PLANE_ALIGNMENT;
+}
+
+/********** CvPlanes_init ********
+ *
+ *  Lays the Y, Pb and Pr planes of an image out over storage the caller
+ *  owns
+ *
+ * Parameters:
+ *      CvPlanes_T planes: the struct to fill in
+ *      unsigned width:    the width of the image in pixels
+ *      unsigned height:   the height of the image in pixels
+ *      void *values:      64-byte aligned storage, CvPlanes_bytes long
+ *
+ * Return:
+ *      none
+ *
+ * Expects
+ *      planes and values to not be null
+ *
+ * Notes:
+ *      Will CRE if planes or values is null
+ *      The values of the planes are uninitialized
+ *
+ ************************/
+void CvPlanes_init(CvPlanes_T planes, unsigned width, unsigned height,
+                   void *values)
+{
+        assert(planes != NULL);
+        assert(values != NULL);
+
+        planes->width = width;
+        planes->height = height;
+        planes->stride = stride(width);
+
+        size_t planeSize = planes->stride * height;
+        planes->Y = values;
+        planes->Pb = planes->Y + planeSize;
+        planes->Pr = planes->Pb + planeSize;
+}
+
+/********** CvPlanes_free ********
+ *
+ *  Frees the planes and the struct that holds them
+ *
+ * Parameters:
+ *      CvPlanes_T *planes: a pointer to the planes to free
+ *
+ * Return:
+ *      none
+ *
+ * Expects
+ *      planes and *planes to not be null
+ *
+ * Notes:
+ *      Will CRE if planes or *planes is null
+ *      Sets *planes to NULL
+ *
+ ************************/
+void CvPlanes_free(CvPlanes_T *planes)
+{
+        assert(planes != NULL && *planes != NULL);
+
+        free((*planes)->Y);
+        free(*planes);
+        *planes = NULL;
+}
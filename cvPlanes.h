@@ -0,0 +1,45 @@
+/*
+ *      cvPlanes.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for CvPlanes, a whole image in
+ *      component video held as three separate planes of floats, one each
+ *      for Y, Pb and Pr, instead of interleaved componentVideo structs.
+ *      Every plane and every row starts on a 64-byte boundary, so the DCT
+ *      can walk the luma rows and the chroma averaging the chroma rows
+ *      with unit stride.
+ */
+
+#ifndef CV_PLANES
+#define CV_PLANES
+
+#include <stddef.h>
+
+typedef struct CvPlanes_T {
+        unsigned width;
+        unsigned height;
+        size_t stride;   /* floats from the start of one row to the next,
+                            a multiple of 16 */
+        float *Y;        /* luma of every pixel */
+        float *Pb;       /* color difference proportional to B - Y */
+        float *Pr;       /* color difference proportional to R - Y */
+} *CvPlanes_T;
+
+CvPlanes_T CvPlanes_new(unsigned width, unsigned height);
+void CvPlanes_free(CvPlanes_T *planes);
+
+/* for planes whose storage belongs to someone else: values must be 64-byte
+   aligned and CvPlanes_bytes(width, height) long */
+size_t CvPlanes_bytes(unsigned width, unsigned height);
+void CvPlanes_init(CvPlanes_T planes, unsigned width, unsigned height,
+                   void *values);
+
+/* the offset of (col, row) in each of the three planes */
+static inline size_t CvPlanes_index(CvPlanes_T planes, unsigned col,
+                                    unsigned row)
+{
+        return row * planes->stride + col;
+}
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ *      fusedConversions.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation for the fused conversions
+ *      between rows of RGB pixels and rows of codewords. It works through
+ *      a row a chunk at a time, converting each chunk with the color
+ *      kernels into two rows of small component video planes and packing
+ *      those with wordConversions, so its output is identical to the
+ *      staged pipeline.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include "assert.h"
+
+#include "pnm.h"
+#include "cvPlanes.h"
+#include "colorKernels.h"
+#include "wordConversions.h"
+#include "fusedConversions.h"
+
+/* Rows are converted this many pixels, an even number, at a time */
+#define CHUNK_PIXELS 64
+
+/****************************************************************
+*                                                               *
+*                    Compression Functions                      *
+*                                                               *
+*****************************************************************/
+
+/********** encodeRowPair ********
+ *
+ *  To turn two rows of RGB pixels into one row of 32-bit codewords
+ *
+ * Parameters:
+ *      Pnm_rgb top:          the even row of pixels, width pixels long
+ *      Pnm_rgb bottom:       the odd row of pixels below top
+ *      unsigned width:       the number of pixels in each row
+ *      unsigned denominator: the denominator of the original to scale
+ *      uint32_t *words:      the row of width / 2 codewords to fill in
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      top, bottom, and words to not be null
+ *      width to be even
+ * 
+ * Notes:
+ *      Will CRE if top, bottom, or words are null
+ *      Will CRE if width is odd
+ *      Only a chunk of each row is ever held in component video
+ *      
+ ************************/
+void encodeRowPair(Pnm_rgb top, Pnm_rgb bottom, unsigned width, 
+                   unsigned denominator, uint32_t *words)
+{
+        assert(top != NULL);
+        assert(bottom != NULL);
+        assert(words != NULL);
+        assert(width % 2 == 0);
+
+        /* the two rows of a chunk, as planes on the stack */
+        float Y[2 * CHUNK_PIXELS], Pb[2 * CHUNK_PIXELS], Pr[2 * CHUNK_PIXELS];
+        struct CvPlanes_T chunk = { CHUNK_PIXELS, 2, CHUNK_PIXELS, 
+                                    Y, Pb, Pr };
+
+        for (unsigned start = 0; start < width; start += CHUNK_PIXELS) {
+                unsigned count = width - start;
+                if (count > CHUNK_PIXELS) {
+                        count = CHUNK_PIXELS;
+                }
+
+                /* convert the chunk of both rows to component video */
+                ColorKernels_rgbToCv(&top[start], count, denominator, 
+                                     Y, Pb, Pr);
+                ColorKernels_rgbToCv(&bottom[start], count, denominator, 
+                                     Y + CHUNK_PIXELS, Pb + CHUNK_PIXELS, 
+                                     Pr + CHUNK_PIXELS);
+
+                /* and pack its blocks straight into their codewords */
+                packBlockRow(&chunk, 0, count / 2, &words[start / 2]);
+        }
+}
+
+/****************************************************************
+*                                                               *
+*                  Decompression Functions                      *
+*                                                               *
+*****************************************************************/
+
+/********** decodeWordRow ********
+ *
+ *  To turn one row of 32-bit codewords into two rows of 8-bit RGB bytes,
+ *  laid out the way they appear in the body of a P6 image
+ *
+ * Parameters:
+ *      uint32_t *words:      the row of codewords
+ *      unsigned count:       the number of codewords in the row
+ *      unsigned denominator: the denominator to scale the output pixels by
+ *      unsigned char *top:   the even row of 3 * 2 * count bytes to fill in
+ *      unsigned char *bottom: the odd row of 3 * 2 * count bytes to fill in
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      words, top, and bottom to not be null
+ *      denominator to fit in a byte
+ * 
+ * Notes:
+ *      Will CRE if words, top, or bottom are null
+ *      Will CRE if denominator is greater than 255
+ *      
+ ************************/
+void decodeWordRow(uint32_t *words, unsigned count, unsigned denominator,
+                   unsigned char *top, unsigned char *bottom)
+{
+        assert(words != NULL);
+        assert(top != NULL);
+        assert(bottom != NULL);
+        assert(denominator <= 255);
+
+        /* the two rows of a chunk, as planes on the stack, and one row of
+           the chunk as RGB pixels */
+        float Y[2 * CHUNK_PIXELS], Pb[2 * CHUNK_PIXELS], Pr[2 * CHUNK_PIXELS];
+        struct CvPlanes_T chunk = { CHUNK_PIXELS, 2, CHUNK_PIXELS, 
+                                    Y, Pb, Pr };
+        struct Pnm_rgb pixels[CHUNK_PIXELS];
+
+        for (unsigned first = 0; first < count; first += CHUNK_PIXELS / 2) {
+                unsigned blocks = count - first;
+                if (blocks > CHUNK_PIXELS / 2) {
+                        blocks = CHUNK_PIXELS / 2;
+                }
+                unpackBlockRow(&words[first], blocks, &chunk, 0);
+
+                /* each pixel is 3 bytes and each block is 2 pixels wide */
+                for (unsigned half = 0; half < 2; half++) {
+                        unsigned char *dest = (half == 0 ? top : bottom) + 
+                                              6 * first;
+                        size_t offset = half * CHUNK_PIXELS;
+                        ColorKernels_cvToRgb(Y + offset, Pb + offset, 
+                                             Pr + offset, 2 * blocks, 
+                                             denominator, pixels);
+                        storePixels(pixels, 2 * blocks, dest);
+                }
+        }
+}
+
+/********** storePixels ********
+ *
+ *  To store a run of pixels as three bytes each, as in a P6 row
+ *
+ * Parameters:
+ *      Pnm_rgb pixels:       the pixels
+ *      unsigned count:       the number of pixels
+ *      unsigned char *bytes: where the 3 * count bytes go
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      pixels and bytes to not be null
+ *      each sample to fit in a byte
+ *      
+ * Notes:
+ *      Will CRE if pixels or bytes is null
+ *      
+ ************************/
+void storePixels(Pnm_rgb pixels, unsigned count, unsigned char *bytes)
+{
+        assert(pixels != NULL);
+        assert(bytes != NULL);
+
+        for (unsigned i = 0; i < count; i++) {
+                bytes[3 * i] = pixels[i].red;
+                bytes[3 * i + 1] = pixels[i].green;
+                bytes[3 * i + 2] = pixels[i].blue;
+        }
+}
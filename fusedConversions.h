@@ -0,0 +1,30 @@
+/*
+ *      fusedConversions.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for fusedConversions, which performs
+ *      every per-block step of compression (RGB to component video, chroma
+ *      averaging, DCT, quantization, and bitpacking) on a pair of pixel rows
+ *      at once, so that no full-image component video array is needed. It
+ *      also performs every decompression step on a row of codewords,
+ *      producing two rows of output bytes.
+ */
+
+#ifndef FUSED_CONVERSIONS
+#define FUSED_CONVERSIONS
+
+#include <stdint.h>
+#include "pnm.h"
+
+/* Compression */
+void encodeRowPair(Pnm_rgb top, Pnm_rgb bottom, unsigned width, 
+                   unsigned denominator, uint32_t *words);
+
+/* Decompression */
+void decodeWordRow(uint32_t *words, unsigned count, unsigned denominator,
+                   unsigned char *top, unsigned char *bottom);
+/* stores count pixels as the 3 * count bytes of a P6 row */
+void storePixels(Pnm_rgb pixels, unsigned count, unsigned char *bytes);
+
+#endif
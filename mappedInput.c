@@ -0,0 +1,165 @@
+/*
+ *      mappedInput.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation for the MappedInput 
+ *      abstraction. The whole file is mapped read-only, since mappings must
+ *      start on a page boundary, and the kernel is told it will be read 
+ *      sequentially so that it reads ahead aggressively and drops pages 
+ *      behind the reader.
+ */
+
+/* fileno, ftello, fseeko, and the mmap family are POSIX, not C99 */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "assert.h"
+
+#include "mappedInput.h"
+
+/* MappedInput_T struct that stores the mapping and how far into it the 
+   reader has got */
+struct MappedInput_T {
+        FILE *fp;               /* the stream that was mapped */
+        unsigned char *bytes;   /* the whole file */
+        size_t size;            /* the size of the file */
+        size_t offset;          /* the next byte to take */
+};
+
+/********** MappedInput_new ********
+ *
+ *  Maps the file behind a stream, to be read from the stream's current 
+ *  position
+ *
+ * Parameters:
+ *      FILE *fp: the stream to map
+ *
+ * Return: 
+ *      A new MappedInput_T, or NULL if fp is not a non-empty regular file
+ *      or the mapping fails
+ *
+ * Expects
+ *      fp to not be null
+ * 
+ * Notes:
+ *      Will CRE if fp is null
+ *      Will CRE if memory allocation fails
+ *      The caller must not read from fp until the input is freed
+ *      
+ ************************/
+MappedInput_T MappedInput_new(FILE *fp)
+{
+        assert(fp != NULL);
+
+        struct stat info;
+        int fd = fileno(fp);
+        if (fd < 0 || fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || 
+            info.st_size <= 0 || (uintmax_t)info.st_size > SIZE_MAX) {
+                return NULL;
+        }
+        off_t offset = ftello(fp);
+        if (offset < 0 || offset > info.st_size) {
+                return NULL;
+        }
+
+        size_t size = info.st_size;
+        void *bytes = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (bytes == MAP_FAILED) {
+                return NULL;
+        }
+        posix_madvise(bytes, size, POSIX_MADV_SEQUENTIAL);
+
+        MappedInput_T input = malloc(sizeof(*input));
+        assert(input != NULL);
+        input->fp = fp;
+        input->bytes = bytes;
+        input->size = size;
+        input->offset = offset;
+        return input;
+}
+
+/********** MappedInput_free ********
+ *
+ *  Unmaps the file and leaves its stream positioned just past the last 
+ *  byte taken, so the stream can still be read from or closed normally
+ *
+ * Parameters:
+ *      MappedInput_T *input: a pointer to the input to free
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      input and *input to not be null
+ * 
+ * Notes:
+ *      Will CRE if input or *input is null
+ *      
+ ************************/
+void MappedInput_free(MappedInput_T *input)
+{
+        assert(input != NULL && *input != NULL);
+        fseeko((*input)->fp, (off_t)(*input)->offset, SEEK_SET);
+        munmap((*input)->bytes, (*input)->size);
+        free(*input);
+        *input = NULL;
+}
+
+/********** MappedInput_take ********
+ *
+ *  Takes the next bytes of the file
+ *
+ * Parameters:
+ *      MappedInput_T input: the input to take from
+ *      size_t length:       the number of bytes to take
+ *
+ * Return: 
+ *      A pointer to the bytes, valid until the input is freed, or NULL if 
+ *      fewer than length bytes are left, in which case nothing is taken
+ *
+ * Expects
+ *      input to not be null
+ * 
+ * Notes:
+ *      Will CRE if input is null
+ *      
+ ************************/
+const unsigned char *MappedInput_take(MappedInput_T input, size_t length)
+{
+        assert(input != NULL);
+        if (length > input->size - input->offset) {
+                return NULL;
+        }
+        const unsigned char *bytes = input->bytes + input->offset;
+        input->offset += length;
+        return bytes;
+}
+
+/********** MappedInput_left ********
+ *
+ *  Tells how much of the file has not been taken yet, so a reader can 
+ *  tell that a file is too short before reading any of it
+ *
+ * Parameters:
+ *      MappedInput_T input: the input
+ *
+ * Return: 
+ *      The number of bytes left
+ *
+ * Expects
+ *      input to not be null
+ * 
+ * Notes:
+ *      Will CRE if input is null
+ *      
+ ************************/
+size_t MappedInput_left(MappedInput_T input)
+{
+        assert(input != NULL);
+        return input->size - input->offset;
+}
@@ -0,0 +1,33 @@
+/*
+ *      mappedInput.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the MappedInput abstraction, 
+ *      which maps the rest of an open regular file into memory so that a 
+ *      reader can take its bytes straight from the mapped pages instead of
+ *      copying them through a stdio buffer. Pipes and terminals cannot be
+ *      mapped; for them MappedInput_new returns NULL and the caller keeps
+ *      reading through stdio.
+ */
+
+#ifndef MAPPED_INPUT
+#define MAPPED_INPUT
+
+#include <stddef.h>
+#include <stdio.h>
+
+typedef struct MappedInput_T *MappedInput_T;
+
+/* maps fp from its current position; NULL if it cannot be mapped */
+MappedInput_T MappedInput_new(FILE *fp);
+/* unmaps the file and moves fp just past the bytes that were taken */
+void MappedInput_free(MappedInput_T *input);
+
+/* returns the next length bytes and moves past them, or NULL if fewer
+   than length bytes are left */
+const unsigned char *MappedInput_take(MappedInput_T input, size_t length);
+/* returns the number of bytes not yet taken */
+size_t MappedInput_left(MappedInput_T input);
+
+#endif
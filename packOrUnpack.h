@@ -19,9 +19,7 @@
 uint32_t bitpack(uint64_t a, int64_t b, int64_t c, int64_t d, 
                       uint64_t pb, uint64_t pr);
 
-/* Decompression */
-uint32_t unpackUnsigned(uint32_t word, char *value);
-int32_t unpackSigned(uint32_t word, char *value);
+/* Decompression is done with the Codeword_<field> functions of codeword.h */
 
 #undef PACKORUNPACK_H
 #endif
\ No newline at end of file
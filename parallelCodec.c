@@ -0,0 +1,482 @@
+/*
+ *      parallelCodec.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation for the parallel compressor and
+ *      decompressor. Each image is read by a load task on the work-stealing
+ *      Scheduler, which splits it into tiles of codeword rows and submits
+ *      them as more tasks. The tiles of a large image spread across every
+ *      idle worker, while a small image that makes a single tile runs whole
+ *      on the worker that loaded it. The calling thread writes each image 
+ *      to stdout, in order, as soon as all of its tiles are done.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "assert.h"
+
+#include "pnm.h"
+#include "fusedConversions.h"
+#include "ppmReader.h"
+#include "readOrWrite.h"
+#include "ppmWriter.h"
+#include "workStealing.h"
+#include "parallelCodec.h"
+
+/* The maxval of every decompressed image, as in compress40.c */
+extern const unsigned CUSTOM_DENOMINATOR;
+
+/* The number of codewords each tile aims to convert */
+static const unsigned TILE_WORDS = 16384;
+
+/* The number of images per worker that may be loaded at once */
+static const unsigned IMAGES_PER_WORKER = 2;
+
+/* the batch struct is shared by every image in one call, and lets the 
+   calling thread sleep until the image it writes next is done */
+struct batch {
+        Scheduler_T scheduler;
+        pthread_mutex_t lock;
+        pthread_cond_t imageDone;
+};
+
+/* the imageJob struct holds one image while it is being converted */
+struct imageJob {
+        struct batch *batch;
+        char *path;              /* the file to open, or NULL for input */
+        FILE *input;
+        bool compressing;
+        Pnm_rgb pixels;          /* compression: the pixels, row by row */
+        unsigned fullWidth;      /* compression: pixels in each stored row */
+        unsigned denominator;    /* the maxval of the pixels */
+        uint32_t *words;         /* the codewords, row by row */
+        unsigned count;          /* the number of codewords in each row */
+        unsigned rows;           /* the number of codeword rows */
+        unsigned char *bytes;    /* decompression: the P6 raster */
+        struct tile *tiles;
+        unsigned tilesLeft;      /* protected by the batch lock */
+        bool done;               /* protected by the batch lock */
+};
+
+/* the tile struct is one task, converting the codeword rows 
+   [first, last) of an image */
+struct tile {
+        struct imageJob *image;
+        unsigned first, last;
+};
+
+static void convertImages(FILE *input, char **paths, unsigned count, 
+                          bool compressing, unsigned threads);
+static void loadImage(void *vimage);
+static void readPixels(struct imageJob *image);
+static void readWords(struct imageJob *image);
+static void convertTile(void *vtile);
+static void finishImage(struct imageJob *image);
+static void writeImage(struct imageJob *image);
+
+/********** compress40Parallel ********
+ *
+ * Compresses a given .PPM image like compress40, splitting the work into
+ * tiles of rows that are encoded on separate threads
+ *
+ * Parameters:
+ *      FILE *input:      a pointer to the file to be compressed
+ *      unsigned threads: the number of worker threads
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      FILE *input to not be null
+ *      threads to be at least 1
+ *      File to be in correct PPM format
+ * 
+ * Notes:
+ *      Will CRE if the input file pointer is null or threads is 0
+ *      Will CRE if the PPM header is malformed or the image is truncated
+ *      Will CRE if memory allocation or thread creation fails
+ *      An odd last row is never read and an odd last column is skipped
+ *      
+ ************************/
+void compress40Parallel(FILE *input, unsigned threads)
+{
+        assert(input != NULL);
+        convertImages(input, NULL, 1, true, threads);
+}
+
+/********** decompress40Parallel ********
+ *
+ * Decompresses a given image like decompress40, splitting the work into 
+ * tiles of codeword rows that are decoded on separate threads
+ *
+ * Parameters:
+ *      FILE *input:      a pointer to the file to be decompressed
+ *      unsigned threads: the number of worker threads
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      FILE *input to not be null
+ *      threads to be at least 1
+ * 
+ * Notes:
+ *      Will CRE if the input file pointer is null or threads is 0
+ *      Will CRE if the compressed file is malformed or truncated
+ *      Will CRE if memory allocation or thread creation fails
+ *      
+ ************************/
+void decompress40Parallel(FILE *input, unsigned threads)
+{
+        assert(input != NULL);
+        convertImages(input, NULL, 1, false, threads);
+}
+
+/********** compress40Files ********
+ *
+ * Compresses several .PPM files with one shared pool of worker threads,
+ * writing their compressed forms to stdout one after another, in order
+ *
+ * Parameters:
+ *      char **paths:     the names of the files to be compressed
+ *      unsigned count:   the number of files
+ *      unsigned threads: the number of worker threads
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      paths and every name in it to not be null
+ *      threads to be at least 1
+ * 
+ * Notes:
+ *      Will CRE if a file cannot be opened
+ *      Will CRE under the same conditions as compress40Parallel
+ *      Each file is only open while it is being read
+ *      
+ ************************/
+void compress40Files(char **paths, unsigned count, unsigned threads)
+{
+        assert(paths != NULL);
+        convertImages(NULL, paths, count, true, threads);
+}
+
+/********** decompress40Files ********
+ *
+ * Decompresses several files with one shared pool of worker threads,
+ * writing them to stdout one after another, in order
+ *
+ * Parameters:
+ *      char **paths:     the names of the files to be decompressed
+ *      unsigned count:   the number of files
+ *      unsigned threads: the number of worker threads
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      paths and every name in it to not be null
+ *      threads to be at least 1
+ * 
+ * Notes:
+ *      Will CRE if a file cannot be opened
+ *      Will CRE under the same conditions as decompress40Parallel
+ *      Each file is only open while it is being read
+ *      
+ ************************/
+void decompress40Files(char **paths, unsigned count, unsigned threads)
+{
+        assert(paths != NULL);
+        convertImages(NULL, paths, count, false, threads);
+}
+
+/********** convertImages ********
+ *
+ * Runs every image through the scheduler and writes each one as soon as 
+ * it and every image before it are done
+ *
+ * Parameters:
+ *      FILE *input:       the single open file to convert, or NULL
+ *      char **paths:      if input is NULL, the names of the files to convert
+ *      unsigned count:    the number of files
+ *      bool compressing:  true to compress, false to decompress
+ *      unsigned threads:  the number of worker threads
+ *
+ * Return: 
+ *      none
+ *
+ * Notes:
+ *      Will CRE if threads is 0
+ *      Will CRE if memory allocation fails
+ *      At most IMAGES_PER_WORKER images per worker are in memory at once
+ *      
+ ************************/
+static void convertImages(FILE *input, char **paths, unsigned count, 
+                          bool compressing, unsigned threads)
+{
+        assert(threads > 0);
+
+        struct batch batch;
+        batch.scheduler = Scheduler_new(threads);
+        pthread_mutex_init(&batch.lock, NULL);
+        pthread_cond_init(&batch.imageDone, NULL);
+
+        struct imageJob *images = calloc(count + 1, sizeof(*images));
+        assert(images != NULL);
+        unsigned window = IMAGES_PER_WORKER * threads;
+        unsigned loaded = 0;
+
+        for (unsigned i = 0; i < count; i++) {
+                /* keep the window of images after this one loading */
+                for (; loaded < count && loaded < i + window; loaded++) {
+                        images[loaded].batch = &batch;
+                        images[loaded].input = input;
+                        images[loaded].path = input ? NULL : paths[loaded];
+                        images[loaded].compressing = compressing;
+                        Scheduler_submit(batch.scheduler, loadImage, 
+                                         &images[loaded]);
+                }
+
+                pthread_mutex_lock(&batch.lock);
+                while (!images[i].done) {
+                        pthread_cond_wait(&batch.imageDone, &batch.lock);
+                }
+                pthread_mutex_unlock(&batch.lock);
+
+                writeImage(&images[i]);
+        }
+
+        Scheduler_free(&batch.scheduler);
+        pthread_mutex_destroy(&batch.lock);
+        pthread_cond_destroy(&batch.imageDone);
+        free(images);
+}
+
+/********** loadImage ********
+ *
+ * Task that reads one image and submits its tiles
+ *
+ * Parameters:
+ *      void *vimage: the struct imageJob to load
+ *
+ * Return: 
+ *      none
+ *
+ * Notes:
+ *      Will CRE if the file cannot be opened or the input is malformed
+ *      Will CRE if memory allocation fails
+ *      
+ ************************/
+static void loadImage(void *vimage)
+{
+        struct imageJob *image = vimage;
+        if (image->path != NULL) {
+                image->input = fopen(image->path, "rb");
+                assert(image->input != NULL);
+        }
+        if (image->compressing) {
+                readPixels(image);
+        } else {
+                readWords(image);
+        }
+        if (image->path != NULL) {
+                fclose(image->input);
+        }
+
+        /* tiles are whole codeword rows, about TILE_WORDS words each */
+        unsigned rowsPerTile = 1;
+        if (image->count > 0 && image->count < TILE_WORDS) {
+                rowsPerTile = TILE_WORDS / image->count;
+        }
+        unsigned tiles = (image->rows + rowsPerTile - 1) / rowsPerTile;
+        if (image->count == 0 || tiles == 0) {
+                finishImage(image);
+                return;
+        }
+
+        image->tiles = malloc(tiles * sizeof(*image->tiles));
+        assert(image->tiles != NULL);
+        image->tilesLeft = tiles;
+        for (unsigned i = 0; i < tiles; i++) {
+                image->tiles[i].image = image;
+                image->tiles[i].first = i * rowsPerTile;
+                image->tiles[i].last = (i + 1) * rowsPerTile;
+                if (image->tiles[i].last > image->rows) {
+                        image->tiles[i].last = image->rows;
+                }
+        }
+        /* this worker pops the newest tile first, so submit the first 
+           tile last; thieves take the later tiles */
+        for (unsigned i = tiles; i > 0; i--) {
+                Scheduler_submit(image->batch->scheduler, convertTile, 
+                                 &image->tiles[i - 1]);
+        }
+}
+
+/********** readPixels ********
+ *
+ * Reads every row of a PPM image that will be encoded
+ *
+ * Parameters:
+ *      struct imageJob *image: the image to read into
+ *
+ * Return: 
+ *      none
+ *
+ * Notes:
+ *      Will CRE if the PPM header is malformed or the image is truncated
+ *      Will CRE if memory allocation fails
+ *      
+ ************************/
+static void readPixels(struct imageJob *image)
+{
+        PpmReader_T reader = PpmReader_new(image->input);
+        assert(reader != NULL);
+        size_t fullWidth = PpmReader_width(reader);
+        unsigned height = PpmReader_height(reader);
+        height -= height % 2;
+
+        image->fullWidth = fullWidth;
+        image->denominator = PpmReader_denominator(reader);
+        image->count = fullWidth / 2;
+        image->rows = height / 2;
+        image->pixels = malloc((fullWidth * height + 1) * 
+                               sizeof(*image->pixels));
+        image->words = malloc(((size_t)image->count * image->rows + 1) * 
+                              sizeof(*image->words));
+        assert(image->pixels != NULL && image->words != NULL);
+
+        for (unsigned row = 0; row < height; row++) {
+                bool read = PpmReader_readRow(reader, 
+                                              &image->pixels[row * fullWidth]);
+                assert(read);
+        }
+        PpmReader_free(&reader);
+}
+
+/********** readWords ********
+ *
+ * Reads every codeword of a compressed image
+ *
+ * Parameters:
+ *      struct imageJob *image: the image to read into
+ *
+ * Return: 
+ *      none
+ *
+ * Notes:
+ *      Will CRE if the compressed file is malformed or truncated
+ *      Will CRE if memory allocation fails
+ *      
+ ************************/
+static void readWords(struct imageJob *image)
+{
+        unsigned width, height;
+        readCompressedHeader(image->input, &width, &height);
+
+        image->denominator = CUSTOM_DENOMINATOR;
+        image->count = width / 2;
+        image->rows = height / 2;
+
+        /* each codeword row becomes two rows of 3 bytes per pixel */
+        size_t words = (size_t)image->count * image->rows;
+        image->words = malloc((words + 1) * sizeof(*image->words));
+        image->bytes = malloc(12 * words + 1);
+        assert(image->words != NULL && image->bytes != NULL);
+
+        MappedInput_T mapped = MappedInput_new(image->input);
+        if (!takeWordRow(image->input, mapped, image->words, words)) {
+                exitTruncated();
+        }
+        if (mapped != NULL) {
+                MappedInput_free(&mapped);
+        }
+}
+
+/********** convertTile ********
+ *
+ * Task that encodes or decodes the codeword rows of one tile
+ *
+ * Parameters:
+ *      void *vtile: the struct tile to convert
+ *
+ * Return: 
+ *      none
+ *
+ ************************/
+static void convertTile(void *vtile)
+{
+        struct tile *tile = vtile;
+        struct imageJob *image = tile->image;
+        size_t count = image->count;
+
+        for (unsigned row = tile->first; row < tile->last; row++) {
+                uint32_t *words = &image->words[row * count];
+                if (image->compressing) {
+                        Pnm_rgb top = &image->pixels[2 * (size_t)row *
+                                                     image->fullWidth];
+                        encodeRowPair(top, top + image->fullWidth, 
+                                      2 * count, image->denominator, words);
+                } else {
+                        unsigned char *top = &image->bytes[12 * (size_t)row * 
+                                                              count];
+                        decodeWordRow(words, count, image->denominator, 
+                                      top, top + 6 * count);
+                }
+        }
+
+        pthread_mutex_lock(&image->batch->lock);
+        bool last = (--image->tilesLeft == 0);
+        pthread_mutex_unlock(&image->batch->lock);
+        if (last) {
+                finishImage(image);
+        }
+}
+
+/********** finishImage ********
+ *
+ * Marks an image as done and wakes the thread that writes it
+ *
+ ************************/
+static void finishImage(struct imageJob *image)
+{
+        pthread_mutex_lock(&image->batch->lock);
+        image->done = true;
+        pthread_cond_broadcast(&image->batch->imageDone);
+        pthread_mutex_unlock(&image->batch->lock);
+}
+
+/********** writeImage ********
+ *
+ * Writes a converted image to stdout and frees its buffers
+ *
+ * Parameters:
+ *      struct imageJob *image: the image to write
+ *
+ * Return: 
+ *      none
+ *
+ ************************/
+static void writeImage(struct imageJob *image)
+{
+        size_t count = image->count;
+        if (image->compressing) {
+                writeCompressedHeader(stdout, 2 * count, 2 * image->rows);
+                writeWordRow(stdout, image->words, count * image->rows);
+        } else {
+                PpmWriter_T writer = PpmWriter_new(stdout, 2 * count, 
+                                                   2 * image->rows, 
+                                                   image->denominator);
+                assert(writer != NULL);
+                PpmWriter_write(writer, image->bytes, 2 * image->rows);
+                PpmWriter_free(&writer);
+        }
+
+        free(image->pixels);
+        free(image->words);
+        free(image->bytes);
+        free(image->tiles);
+}
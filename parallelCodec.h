@@ -0,0 +1,25 @@
+/*
+ *      parallelCodec.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the parallel compressor and
+ *      decompressor. Every 2x2 block, and every codeword, is independent of
+ *      the others, so images are split into tiles of codeword rows that are
+ *      converted on a pool of worker threads. The output is byte-for-byte
+ *      identical to compress40 and decompress40.
+ */
+
+#ifndef PARALLEL_CODEC
+#define PARALLEL_CODEC
+
+#include <stdio.h>
+
+void compress40Parallel(FILE *input, unsigned threads);
+void decompress40Parallel(FILE *input, unsigned threads);
+
+/* Several files share one pool; their outputs go to stdout in order */
+void compress40Files(char **paths, unsigned count, unsigned threads);
+void decompress40Files(char **paths, unsigned count, unsigned threads);
+
+#endif
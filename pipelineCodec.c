@@ -0,0 +1,552 @@
+/*
+ *      pipelineCodec.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation for the pipelined compressor 
+ *      and decompressor. Chunks of codeword rows are handed to the compute
+ *      threads in turn, each through its own ring, and the writer (the 
+ *      calling thread) collects them from the compute threads in the same
+ *      turn order, so every ring has exactly one producer and one consumer
+ *      and the output stays in order. Written chunks go back to the reader
+ *      through one more ring, so the memory in use is fixed up front.
+ */
+
+/* nanosleep is POSIX, not C99 */
+#define _POSIX_C_SOURCE 199309L
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+#include "assert.h"
+
+#include "pnm.h"
+#include "fusedConversions.h"
+#include "ppmReader.h"
+#include "readOrWrite.h"
+#include "ppmWriter.h"
+#include "ringBuffer.h"
+#include "pipelineCodec.h"
+
+/* The maxval of every decompressed image, as in compress40.c */
+extern const unsigned CUSTOM_DENOMINATOR;
+
+/* The number of codewords each chunk aims to hold */
+static const unsigned CHUNK_WORDS = 16384;
+
+/* How many times a waiting stage yields before it starts to sleep */
+static const unsigned SPINS_BEFORE_SLEEP = 64;
+
+/* How long a waiting stage sleeps between looks at a ring */
+static const long SLEEP_NANOSECONDS = 50000;
+
+/* A chunk of consecutive codeword rows on its way through the pipeline */
+struct chunk {
+        unsigned first;          /* the first codeword row */
+        unsigned rows;           /* the number of codeword rows */
+        Pnm_rgb pixels;          /* compression: 2 * rows pixel rows */
+        uint32_t *words;         /* the codewords, row by row */
+        unsigned char *bytes;    /* decompression: 2 * rows P6 rows */
+};
+
+/* A compute thread and the counters that only it updates */
+struct computeStage {
+        pthread_t thread;
+        struct pipeline *pipeline;
+        Ring_T in;               /* chunks from the reader */
+        Ring_T out;              /* chunks for the writer */
+        unsigned stalls;
+        unsigned maxDepth;
+};
+
+/* Everything shared by the stages; after setup only the rings change */
+struct pipeline {
+        bool compressing;
+        FILE *input;
+        PpmReader_T reader;      /* compression: the open PPM reader */
+        MappedInput_T mapped;    /* decompression: the mapped input, or 
+                                    NULL to read through input */
+        PpmWriter_T ppmWriter;   /* decompression: writes the output */
+        unsigned fullWidth;      /* compression: pixels in each input row */
+        unsigned denominator;    /* the maxval of the pixels */
+        unsigned count;          /* codewords in each row */
+        unsigned rows;           /* codeword rows in the image */
+        unsigned rowsPerChunk;
+        unsigned computeThreads;
+        struct computeStage *stages;
+        Ring_T freeChunks;       /* written chunks, back to the reader */
+        struct chunk *chunks;
+        unsigned chunkCount;
+        struct chunk end;        /* passed along to mark the end of input */
+        unsigned readerStalls;   /* updated only by the reader */
+};
+
+static void runPipeline(struct pipeline *pipeline, 
+                        struct pipelineOptions options,
+                        struct pipelineStats *stats);
+static void *readStage(void *vpipeline);
+static void *computeStage(void *vstage);
+static void writeStage(struct pipeline *pipeline, unsigned *stalls, 
+                       unsigned *maxDepth, unsigned *chunks);
+static void pushWaiting(Ring_T ring, void *item, unsigned *stalls);
+static void *popWaiting(Ring_T ring, unsigned *stalls, unsigned *maxDepth);
+static void backOff(unsigned tries);
+
+/****************************************************************
+*                                                               *
+*                  Compression Functions                        *
+*                                                               *
+*****************************************************************/
+
+/********** compress40Pipelined ********
+ *
+ * Compresses a given .PPM image like compress40, overlapping the reading,
+ * encoding, and writing of the image
+ *
+ * Parameters:
+ *      FILE *input:                    the file to be compressed
+ *      struct pipelineOptions options: how to build the pipeline
+ *      struct pipelineStats *stats:    where to report how it ran, or NULL
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      FILE *input to not be null
+ *      options to ask for at least one compute thread and a depth of 1
+ *      File to be in correct PPM format
+ * 
+ * Notes:
+ *      Will CRE if the input file pointer is null or options are invalid
+ *      Will CRE if the PPM header is malformed or the image is truncated
+ *      Will CRE if memory allocation or thread creation fails
+ *      An odd last row is never read and an odd last column is skipped
+ *      
+ ************************/
+void compress40Pipelined(FILE *input, struct pipelineOptions options,
+                         struct pipelineStats *stats)
+{
+        assert(input != NULL);
+
+        struct pipeline pipeline = { .compressing = true, .input = input };
+        pipeline.reader = PpmReader_new(input);
+        assert(pipeline.reader != NULL);
+        pipeline.fullWidth = PpmReader_width(pipeline.reader);
+        pipeline.denominator = PpmReader_denominator(pipeline.reader);
+        pipeline.count = pipeline.fullWidth / 2;
+        pipeline.rows = PpmReader_height(pipeline.reader) / 2;
+
+        runPipeline(&pipeline, options, stats);
+        PpmReader_free(&pipeline.reader);
+}
+
+/****************************************************************
+*                                                               *
+*                  Decompression Functions                      *
+*                                                               *
+*****************************************************************/
+
+/********** decompress40Pipelined ********
+ *
+ * Decompresses a given image like decompress40, overlapping the reading,
+ * decoding, and writing of the image
+ *
+ * Parameters:
+ *      FILE *input:                    the file to be decompressed
+ *      struct pipelineOptions options: how to build the pipeline
+ *      struct pipelineStats *stats:    where to report how it ran, or NULL
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      FILE *input to not be null
+ *      options to ask for at least one compute thread and a depth of 1
+ * 
+ * Notes:
+ *      Will CRE if the input file pointer is null or options are invalid
+ *      Will CRE if the compressed file is malformed or truncated
+ *      Will CRE if memory allocation or thread creation fails
+ *      
+ ************************/
+void decompress40Pipelined(FILE *input, struct pipelineOptions options,
+                           struct pipelineStats *stats)
+{
+        assert(input != NULL);
+
+        struct pipeline pipeline = { .compressing = false, .input = input };
+        unsigned width, height;
+        readCompressedHeader(input, &width, &height);
+        pipeline.denominator = CUSTOM_DENOMINATOR;
+        pipeline.count = width / 2;
+        pipeline.rows = height / 2;
+        pipeline.mapped = MappedInput_new(input);
+
+        runPipeline(&pipeline, options, stats);
+        if (pipeline.mapped != NULL) {
+                MappedInput_free(&pipeline.mapped);
+        }
+}
+
+/****************************************************************
+*                                                               *
+*           Compression and Decompression Functions             *
+*                                                               *
+*****************************************************************/
+
+/********** runPipeline ********
+ *
+ * Allocates the chunks and rings, starts the reader and compute threads,
+ * writes the output on the calling thread, and cleans up
+ *
+ * Parameters:
+ *      struct pipeline *pipeline:      the image, with its header read
+ *      struct pipelineOptions options: how to build the pipeline
+ *      struct pipelineStats *stats:    where to report how it ran, or NULL
+ *
+ * Return: 
+ *      none
+ *
+ * Notes:
+ *      Will CRE if options are invalid
+ *      Will CRE if memory allocation or thread creation fails
+ *      
+ ************************/
+static void runPipeline(struct pipeline *pipeline, 
+                        struct pipelineOptions options,
+                        struct pipelineStats *stats)
+{
+        assert(options.computeThreads > 0);
+        assert(options.queueDepth > 0);
+        unsigned threads = options.computeThreads;
+
+        /* chunks are whole codeword rows, about CHUNK_WORDS words each */
+        size_t count = pipeline->count;
+        pipeline->rowsPerChunk = CHUNK_WORDS;
+        if (count > 0) {
+                pipeline->rowsPerChunk = (count < CHUNK_WORDS) 
+                                         ? CHUNK_WORDS / count : 1;
+        }
+        if (pipeline->rowsPerChunk > pipeline->rows && pipeline->rows > 0) {
+                pipeline->rowsPerChunk = pipeline->rows;
+        }
+        size_t rows = pipeline->rowsPerChunk;
+
+        /* enough chunks for every compute ring to fill, plus one in the
+           hands of each compute thread and one for the writer */
+        pipeline->computeThreads = threads;
+        pipeline->chunkCount = threads * (options.queueDepth + 1) + 1;
+        pipeline->chunks = calloc(pipeline->chunkCount, 
+                                  sizeof(*pipeline->chunks));
+        assert(pipeline->chunks != NULL);
+        pipeline->freeChunks = Ring_new(pipeline->chunkCount);
+        for (unsigned i = 0; i < pipeline->chunkCount; i++) {
+                struct chunk *chunk = &pipeline->chunks[i];
+                chunk->words = malloc((rows * count + 1) * 
+                                      sizeof(*chunk->words));
+                assert(chunk->words != NULL);
+                if (pipeline->compressing) {
+                        chunk->pixels = malloc((2 * rows * 
+                                                pipeline->fullWidth + 1) * 
+                                               sizeof(*chunk->pixels));
+                        assert(chunk->pixels != NULL);
+                } else {
+                        chunk->bytes = malloc(12 * rows * count + 1);
+                        assert(chunk->bytes != NULL);
+                }
+                Ring_push(pipeline->freeChunks, chunk);
+        }
+
+        pipeline->stages = calloc(threads, sizeof(*pipeline->stages));
+        assert(pipeline->stages != NULL);
+        for (unsigned i = 0; i < threads; i++) {
+                pipeline->stages[i].pipeline = pipeline;
+                pipeline->stages[i].in = Ring_new(options.queueDepth);
+                pipeline->stages[i].out = Ring_new(options.queueDepth);
+        }
+
+        /* the header goes out before any rows are read */
+        if (pipeline->compressing) {
+                writeCompressedHeader(stdout, 2 * count, 
+                                      2 * pipeline->rows);
+        } else {
+                pipeline->ppmWriter = PpmWriter_new(stdout, 2 * count, 
+                                                    2 * pipeline->rows, 
+                                                    pipeline->denominator);
+                assert(pipeline->ppmWriter != NULL);
+        }
+
+        pthread_t reader;
+        int made = pthread_create(&reader, NULL, readStage, pipeline);
+        assert(made == 0);
+        for (unsigned i = 0; i < threads; i++) {
+                made = pthread_create(&pipeline->stages[i].thread, NULL, 
+                                      computeStage, &pipeline->stages[i]);
+                assert(made == 0);
+        }
+
+        unsigned writerStalls = 0, writerMaxDepth = 0, chunks = 0;
+        writeStage(pipeline, &writerStalls, &writerMaxDepth, &chunks);
+        if (!pipeline->compressing) {
+                PpmWriter_free(&pipeline->ppmWriter);
+        }
+
+        pthread_join(reader, NULL);
+        unsigned computeStalls = 0, maxDepth = writerMaxDepth;
+        for (unsigned i = 0; i < threads; i++) {
+                struct computeStage *stage = &pipeline->stages[i];
+                pthread_join(stage->thread, NULL);
+                computeStalls += stage->stalls;
+                if (stage->maxDepth > maxDepth) {
+                        maxDepth = stage->maxDepth;
+                }
+                Ring_free(&stage->in);
+                Ring_free(&stage->out);
+        }
+
+        if (stats != NULL) {
+                stats->chunks = chunks;
+                stats->rowsPerChunk = pipeline->rowsPerChunk;
+                stats->readerStalls = pipeline->readerStalls;
+                stats->computeStalls = computeStalls;
+                stats->writerStalls = writerStalls;
+                stats->maxDepth = maxDepth;
+        }
+
+        for (unsigned i = 0; i < pipeline->chunkCount; i++) {
+                free(pipeline->chunks[i].pixels);
+                free(pipeline->chunks[i].words);
+                free(pipeline->chunks[i].bytes);
+        }
+        free(pipeline->chunks);
+        free(pipeline->stages);
+        Ring_free(&pipeline->freeChunks);
+}
+
+/********** readStage ********
+ *
+ * Thread function of the reader: fills free chunks with rows of the input
+ * and deals them out to the compute threads in turn
+ *
+ * Parameters:
+ *      void *vpipeline: the struct pipeline
+ *
+ * Return: 
+ *      NULL
+ *
+ * Notes:
+ *      Will CRE if the input is truncated
+ *      
+ ************************/
+static void *readStage(void *vpipeline)
+{
+        struct pipeline *pipeline = vpipeline;
+        unsigned threads = pipeline->computeThreads;
+        unsigned turn = 0;
+
+        for (unsigned first = 0; first < pipeline->rows; 
+             first += pipeline->rowsPerChunk) {
+                struct chunk *chunk = popWaiting(pipeline->freeChunks, 
+                                                 &pipeline->readerStalls, 
+                                                 NULL);
+                chunk->first = first;
+                chunk->rows = pipeline->rows - first;
+                if (chunk->rows > pipeline->rowsPerChunk) {
+                        chunk->rows = pipeline->rowsPerChunk;
+                }
+
+                if (pipeline->compressing) {
+                        bool read = true;
+                        size_t fullWidth = pipeline->fullWidth;
+                        for (unsigned row = 0; row < 2 * chunk->rows; row++) {
+                                read = read && PpmReader_readRow(
+                                                pipeline->reader, 
+                                                &chunk->pixels[row * 
+                                                               fullWidth]);
+                        }
+                        assert(read);
+                } else if (!takeWordRow(pipeline->input, pipeline->mapped, 
+                                        chunk->words, 
+                                        chunk->rows * pipeline->count)) {
+                        exitTruncated();
+                }
+
+                pushWaiting(pipeline->stages[turn].in, chunk, 
+                            &pipeline->readerStalls);
+                turn = (turn + 1) % threads;
+        }
+
+        /* every compute thread passes the end marker on to the writer */
+        for (unsigned i = 0; i < threads; i++) {
+                pushWaiting(pipeline->stages[i].in, &pipeline->end, 
+                            &pipeline->readerStalls);
+        }
+        return NULL;
+}
+
+/********** computeStage ********
+ *
+ * Thread function of a compute thread: encodes or decodes each chunk it is
+ * given and passes it on to the writer, until the end marker arrives
+ *
+ * Parameters:
+ *      void *vstage: the struct computeStage of this thread
+ *
+ * Return: 
+ *      NULL
+ *
+ ************************/
+static void *computeStage(void *vstage)
+{
+        struct computeStage *stage = vstage;
+        struct pipeline *pipeline = stage->pipeline;
+        size_t count = pipeline->count;
+
+        for (;;) {
+                struct chunk *chunk = popWaiting(stage->in, &stage->stalls, 
+                                                 &stage->maxDepth);
+                if (chunk != &pipeline->end) {
+                        for (size_t row = 0; row < chunk->rows; row++) {
+                                uint32_t *words = &chunk->words[row * count];
+                                if (pipeline->compressing) {
+                                        Pnm_rgb top = &chunk->pixels[
+                                                2 * row * pipeline->fullWidth];
+                                        encodeRowPair(top, 
+                                                top + pipeline->fullWidth, 
+                                                2 * count, 
+                                                pipeline->denominator, words);
+                                } else {
+                                        unsigned char *top = 
+                                                &chunk->bytes[12 * row * count];
+                                        decodeWordRow(words, count, 
+                                                pipeline->denominator, 
+                                                top, top + 6 * count);
+                                }
+                        }
+                }
+                pushWaiting(stage->out, chunk, &stage->stalls);
+                if (chunk == &pipeline->end) {
+                        return NULL;
+                }
+        }
+}
+
+/********** writeStage ********
+ *
+ * The writer, run on the calling thread: collects chunks from the compute
+ * threads in the order they were dealt out, writes them, and returns them
+ * to the reader
+ *
+ * Parameters:
+ *      struct pipeline *pipeline: the pipeline
+ *      unsigned *stalls:          counts the times the writer waited
+ *      unsigned *maxDepth:        the deepest ring the writer saw
+ *      unsigned *chunks:          counts the chunks written
+ *
+ * Return: 
+ *      none
+ *
+ ************************/
+static void writeStage(struct pipeline *pipeline, unsigned *stalls, 
+                       unsigned *maxDepth, unsigned *chunks)
+{
+        size_t count = pipeline->count;
+        unsigned turn = 0;
+
+        for (;;) {
+                struct chunk *chunk = popWaiting(pipeline->stages[turn].out,
+                                                 stalls, maxDepth);
+                if (chunk == &pipeline->end) {
+                        return;
+                }
+                if (pipeline->compressing) {
+                        writeWordRow(stdout, chunk->words, 
+                                     count * chunk->rows);
+                } else {
+                        PpmWriter_write(pipeline->ppmWriter, chunk->bytes, 
+                                        2 * chunk->rows);
+                }
+                (*chunks)++;
+
+                /* the free ring holds every chunk, so this never waits */
+                Ring_push(pipeline->freeChunks, chunk);
+                turn = (turn + 1) % pipeline->computeThreads;
+        }
+}
+
+/********** pushWaiting ********
+ *
+ * Pushes an item onto a ring, waiting for room if it is full
+ *
+ * Parameters:
+ *      Ring_T ring:      the ring to push onto
+ *      void *item:       the item to push
+ *      unsigned *stalls: counts one stall if the push had to wait
+ *
+ ************************/
+static void pushWaiting(Ring_T ring, void *item, unsigned *stalls)
+{
+        if (Ring_push(ring, item)) {
+                return;
+        }
+        (*stalls)++;
+        for (unsigned tries = 0; !Ring_push(ring, item); tries++) {
+                backOff(tries);
+        }
+}
+
+/********** popWaiting ********
+ *
+ * Pops an item from a ring, waiting for one if it is empty
+ *
+ * Parameters:
+ *      Ring_T ring:        the ring to pop from
+ *      unsigned *stalls:   counts one stall if the pop had to wait
+ *      unsigned *maxDepth: raised to the depth of the ring, if deeper;
+ *                          NULL for the free ring, which is not reported
+ *
+ * Return: 
+ *      the item popped
+ *
+ ************************/
+static void *popWaiting(Ring_T ring, unsigned *stalls, unsigned *maxDepth)
+{
+        if (maxDepth != NULL) {
+                unsigned depth = Ring_depth(ring);
+                if (depth > *maxDepth) {
+                        *maxDepth = depth;
+                }
+        }
+
+        void *item;
+        if (Ring_pop(ring, &item)) {
+                return item;
+        }
+        (*stalls)++;
+        for (unsigned tries = 0; !Ring_pop(ring, &item); tries++) {
+                backOff(tries);
+        }
+        return item;
+}
+
+/********** backOff ********
+ *
+ * Gives up the processor while a stage waits on a ring: yielding at first,
+ * then sleeping briefly so a long wait does not burn a core
+ *
+ * Parameters:
+ *      unsigned tries: how many times the stage has already waited
+ *
+ ************************/
+static void backOff(unsigned tries)
+{
+        if (tries < SPINS_BEFORE_SLEEP) {
+                sched_yield();
+        } else {
+                struct timespec pause = { 0, SLEEP_NANOSECONDS };
+                nanosleep(&pause, NULL);
+        }
+}
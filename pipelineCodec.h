@@ -0,0 +1,43 @@
+/*
+ *      pipelineCodec.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the pipelined compressor and
+ *      decompressor. A reader thread parses the input into chunks of rows, 
+ *      compute threads encode or decode them, and a writer thread writes 
+ *      the results in order, with bounded lock-free rings between the 
+ *      stages so that I/O waits hide behind computation. The output is
+ *      byte-for-byte identical to compress40 and decompress40.
+ */
+
+#ifndef PIPELINE_CODEC
+#define PIPELINE_CODEC
+
+#include <stdio.h>
+
+/* How the pipeline is built */
+struct pipelineOptions {
+        unsigned computeThreads; /* number of compute threads, at least 1 */
+        unsigned queueDepth;     /* chunks each ring can hold, at least 1 */
+};
+
+/* What happened while it ran, for tuning the options. A stall is one time
+   a stage had to wait on a ring: for its input to arrive, or for room to 
+   pass its output on */
+struct pipelineStats {
+        unsigned chunks;         /* chunks of rows that went through */
+        unsigned rowsPerChunk;   /* codeword rows in each full chunk */
+        unsigned readerStalls;   /* reader waited for a free chunk or room */
+        unsigned computeStalls;  /* compute threads waited, in total */
+        unsigned writerStalls;   /* writer waited for the next chunk */
+        unsigned maxDepth;       /* most chunks seen queued in one ring */
+};
+
+/* stats may be NULL */
+void compress40Pipelined(FILE *input, struct pipelineOptions options,
+                         struct pipelineStats *stats);
+void decompress40Pipelined(FILE *input, struct pipelineOptions options,
+                           struct pipelineStats *stats);
+
+#endif
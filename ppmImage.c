@@ -0,0 +1,155 @@
+/*
+ *      ppmImage.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation for the PpmImage abstraction.
+ *      Copied rows start on 64-byte boundaries so that they can be loaded 
+ *      with aligned vector loads.
+ */
+
+/* posix_memalign is POSIX, not C99 */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include "assert.h"
+
+#include "ppmReader.h"
+#include "ppmImage.h"
+
+/* Every row of samples starts on a multiple of this many bytes */
+static const size_t ROW_ALIGNMENT = 64;
+
+/********** PpmImage_read ********
+ *
+ *  Reads a whole PPM image into compact samples, or takes a view of it in
+ *  place, cropped to an even width and height
+ *
+ * Parameters:
+ *      FILE *fp: the stream positioned at the start of the image
+ *
+ * Return: 
+ *      A new PpmImage_T, or NULL if the header is malformed or the image
+ *      ends early
+ *
+ * Expects
+ *      fp to not be null
+ * 
+ * Notes:
+ *      Will CRE if fp is null
+ *      Will CRE if memory allocation fails
+ *      The caller must free the image with PpmImage_free
+ *      The odd last row is never read
+ *      
+ ************************/
+PpmImage_T PpmImage_read(FILE *fp)
+{
+        assert(fp != NULL);
+        PpmReader_T reader = PpmReader_new(fp);
+        if (reader == NULL) {
+                return NULL;
+        }
+
+        PpmImage_T image = malloc(sizeof(*image));
+        assert(image != NULL);
+        image->width = PpmReader_width(reader);
+        image->width -= image->width % 2;
+        image->height = PpmReader_height(reader);
+        image->height -= image->height % 2;
+        image->denominator = PpmReader_denominator(reader);
+        image->bytesPerSample = PpmReader_bytesPerSample(reader);
+        image->copy = NULL;
+        image->reader = NULL;
+
+        /* A mapped 8-bit raw image is cropped by narrowing the view of its
+           rows; the odd last column is skipped by the stride */
+        if (PpmReader_viewable(reader)) {
+                image->stride = (size_t)3 * PpmReader_width(reader);
+                image->samples = PpmReader_viewRows(reader, image->height);
+                image->reader = reader;
+                if (image->samples == NULL) {
+                        PpmImage_free(&image);
+                        return NULL;
+                }
+                return image;
+        }
+
+        size_t rowSize = (size_t)3 * image->bytesPerSample * image->width;
+        image->stride = (rowSize + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * 
+                        ROW_ALIGNMENT;
+        int failed = posix_memalign(&image->copy, ROW_ALIGNMENT, 
+                                    image->stride * image->height + 
+                                    ROW_ALIGNMENT);
+        assert(failed == 0);
+        unsigned char *samples = image->copy;
+        image->samples = samples;
+
+        for (unsigned row = 0; row < image->height; row++) {
+                if (!PpmReader_readSamples(reader, samples + 
+                                           row * image->stride, 
+                                           image->width)) {
+                        PpmReader_free(&reader);
+                        PpmImage_free(&image);
+                        return NULL;
+                }
+        }
+
+        PpmReader_free(&reader);
+        return image;
+}
+
+/********** PpmImage_free ********
+ *
+ *  Frees an image and its samples, or the mapping it is a view of
+ *
+ * Parameters:
+ *      PpmImage_T *image: a pointer to the image to free
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      image and *image to not be null
+ * 
+ * Notes:
+ *      Will CRE if image or *image is null
+ *      
+ ************************/
+void PpmImage_free(PpmImage_T *image)
+{
+        assert(image != NULL && *image != NULL);
+        if ((*image)->reader != NULL) {
+                PpmReader_free(&(*image)->reader);
+        }
+        free((*image)->copy);
+        free(*image);
+        *image = NULL;
+}
+
+/********** PpmImage_row ********
+ *
+ *  Expands a row of compact samples into Pnm_rgb pixels
+ *
+ * Parameters:
+ *      PpmImage_T image: the image
+ *      unsigned row:     the row to expand
+ *      Pnm_rgb pixels:   a buffer of at least width pixels to fill in
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      image and pixels to not be null, and row to be in the image
+ * 
+ * Notes:
+ *      Will CRE if image or pixels is null or row is out of range
+ *      
+ ************************/
+void PpmImage_row(PpmImage_T image, unsigned row, Pnm_rgb pixels)
+{
+        assert(image != NULL && pixels != NULL);
+        assert(row < image->height);
+        for (unsigned col = 0; col < image->width; col++) {
+                PpmImage_pixel(image, col, row, &pixels[col]);
+        }
+}
@@ -0,0 +1,64 @@
+/*
+ *      ppmImage.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the PpmImage abstraction, a 
+ *      whole PPM image held as compact interleaved samples: one byte per 
+ *      sample when the maxval is below 256, otherwise a uint16_t. Images 
+ *      are cropped to an even width and height without copying: the width
+ *      and height shrink but the stride stays, so a raw 8-bit image in a
+ *      mapped file is used in place, a view of the mapped pages. Other 
+ *      images are copied once, dropping the odd edges as they are read.
+ */
+
+#ifndef PPM_IMAGE
+#define PPM_IMAGE
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "pnm.h"
+#include "ppmReader.h"
+
+typedef struct PpmImage_T {
+        unsigned width;          /* even: an odd last column is dropped */
+        unsigned height;         /* even: an odd last row is dropped */
+        unsigned denominator;
+        unsigned bytesPerSample; /* 1 or 2 */
+        size_t stride;           /* bytes from the start of one row to the
+                                    next */
+        const unsigned char *samples; /* red, green, blue for each pixel */
+        void *copy;              /* the samples if they were copied, with
+                                    64-byte aligned rows, or NULL */
+        PpmReader_T reader;      /* keeps the mapping of a view alive, or 
+                                    NULL */
+} *PpmImage_T;
+
+/* returns NULL if fp does not hold a whole P3 or P6 image */
+PpmImage_T PpmImage_read(FILE *fp);
+void PpmImage_free(PpmImage_T *image);
+
+/* expands the pixel at (col, row) */
+static inline void PpmImage_pixel(PpmImage_T image, unsigned col, 
+                                  unsigned row, Pnm_rgb pixel)
+{
+        const unsigned char *samples = image->samples + row * image->stride;
+        if (image->bytesPerSample == 1) {
+                samples += 3 * (size_t)col;
+                pixel->red = samples[0];
+                pixel->green = samples[1];
+                pixel->blue = samples[2];
+        } else {
+                const uint16_t *wide = (const uint16_t *)samples + 
+                                       3 * (size_t)col;
+                pixel->red = wide[0];
+                pixel->green = wide[1];
+                pixel->blue = wide[2];
+        }
+}
+
+/* expands a whole row into width pixels */
+void PpmImage_row(PpmImage_T image, unsigned row, Pnm_rgb pixels);
+
+#endif
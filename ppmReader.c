@@ -0,0 +1,480 @@
+/*
+ *      ppmReader.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation for the ppmReader abstraction.
+ *      Raw images are read a whole row at a time, with one or two bytes per
+ *      sample depending on the maxval: straight from the mapped file when
+ *      it is a regular file, otherwise with fread. Plain images are parsed
+ *      one decimal sample at a time.
+ */
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "assert.h"
+
+#include "mappedInput.h"
+#include "ppmReader.h"
+
+/* The largest maxval allowed by the PPM format */
+static const unsigned PPM_MAX_DENOMINATOR = 65535;
+
+/* Raw samples are one byte when the maxval is below this, otherwise two */
+static const unsigned ONE_BYTE_LIMIT = 256;
+
+/* The largest sample a one-byte raw sample can hold */
+static const unsigned ONE_BYTE_MAX = 255;
+
+/* PpmReader_T struct that stores the header of the image being read and 
+   where raw rows are read from */
+struct PpmReader_T {
+        FILE *fp;               /* the stream the image is read from */
+        unsigned width;
+        unsigned height;
+        unsigned denominator;
+        bool plain;             /* true for P3, false for P6 */
+        unsigned bytesPerSample; /* 1 or 2 for raw images */
+        MappedInput_T mapped;   /* a raw image in a regular file, or NULL */
+        unsigned char *rowBytes; /* one raw row of 3 * width samples, when
+                                    the image is not mapped */
+};
+
+static const unsigned char *rawRow(PpmReader_T reader);
+static bool samplesFit(Pnm_rgb pixels, unsigned width, unsigned denominator);
+static bool readNumber(FILE *fp, unsigned *number);
+static int skipSpaceAndComments(FILE *fp);
+
+/********** PpmReader_new ********
+ *
+ *  Reads the header of a PPM image and prepares to read its rows
+ *
+ * Parameters:
+ *      FILE *fp: the stream positioned at the start of the image
+ *
+ * Return: 
+ *      A new PpmReader_T, or NULL if the header is not a valid P3 or P6 
+ *      header
+ *
+ * Expects
+ *      fp to not be null
+ * 
+ * Notes:
+ *      Will CRE if fp is null
+ *      Will CRE if memory allocation fails
+ *      The caller must free the reader with PpmReader_free
+ *      
+ ************************/
+PpmReader_T PpmReader_new(FILE *fp)
+{
+        assert(fp != NULL);
+
+        /* The magic number must be P3 or P6 */
+        int p = getc(fp);
+        int kind = getc(fp);
+        if (p != 'P' || (kind != '3' && kind != '6')) {
+                return NULL;
+        }
+
+        unsigned width, height, denominator;
+        if (!readNumber(fp, &width) || !readNumber(fp, &height) || 
+            !readNumber(fp, &denominator)) {
+                return NULL;
+        }
+        if (denominator == 0 || denominator > PPM_MAX_DENOMINATOR || 
+            width > INT_MAX / 6) {
+                return NULL;
+        }
+
+        /* A raw raster starts after exactly one whitespace character */
+        if (kind == '6' && !isspace(getc(fp))) {
+                return NULL;
+        }
+
+        PpmReader_T reader = malloc(sizeof(*reader));
+        assert(reader != NULL);
+        reader->fp = fp;
+        reader->width = width;
+        reader->height = height;
+        reader->denominator = denominator;
+        reader->plain = (kind == '3');
+        reader->bytesPerSample = (denominator < ONE_BYTE_LIMIT) ? 1 : 2;
+        reader->mapped = reader->plain ? NULL : MappedInput_new(fp);
+        reader->rowBytes = NULL;
+        if (reader->mapped == NULL) {
+                reader->rowBytes = malloc(3 * reader->bytesPerSample * width
+                                          + 1);
+                assert(reader->rowBytes != NULL);
+        }
+
+        return reader;
+}
+
+/********** PpmReader_free ********
+ *
+ *  Frees a reader and its row buffer or mapping; the stream is left open,
+ *  positioned after the last row read
+ *
+ * Parameters:
+ *      PpmReader_T *reader: a pointer to the reader to free
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      reader and *reader to not be null
+ * 
+ * Notes:
+ *      Will CRE if reader or *reader is null
+ *      
+ ************************/
+void PpmReader_free(PpmReader_T *reader)
+{
+        assert(reader != NULL && *reader != NULL);
+        if ((*reader)->mapped != NULL) {
+                MappedInput_free(&(*reader)->mapped);
+        }
+        free((*reader)->rowBytes);
+        free(*reader);
+        *reader = NULL;
+}
+
+/********** PpmReader_width ********
+ *
+ *  Returns the width of the image given in its header
+ *
+ ************************/
+unsigned PpmReader_width(PpmReader_T reader)
+{
+        assert(reader != NULL);
+        return reader->width;
+}
+
+/********** PpmReader_height ********
+ *
+ *  Returns the height of the image given in its header
+ *
+ ************************/
+unsigned PpmReader_height(PpmReader_T reader)
+{
+        assert(reader != NULL);
+        return reader->height;
+}
+
+/********** PpmReader_denominator ********
+ *
+ *  Returns the maxval of the image given in its header
+ *
+ ************************/
+unsigned PpmReader_denominator(PpmReader_T reader)
+{
+        assert(reader != NULL);
+        return reader->denominator;
+}
+
+/********** PpmReader_readRow ********
+ *
+ *  Reads the next row of the image
+ *
+ * Parameters:
+ *      PpmReader_T reader: the reader to read from
+ *      Pnm_rgb pixels:     a buffer of at least width pixels to fill in
+ *
+ * Return: 
+ *      true if a whole row was read, false if the image ended early, a
+ *      plain sample could not be parsed, or a sample is above the maxval
+ *
+ * Expects
+ *      reader and pixels to not be null
+ * 
+ * Notes:
+ *      Will CRE if reader or pixels is null
+ *      Unlike Pnm_ppmread, samples are checked against the maxval, since
+ *      a larger one would overflow the codeword it is packed into
+ *      
+ ************************/
+bool PpmReader_readRow(PpmReader_T reader, Pnm_rgb pixels)
+{
+        assert(reader != NULL);
+        assert(pixels != NULL);
+        unsigned width = reader->width;
+
+        if (reader->plain) {
+                for (unsigned col = 0; col < width; col++) {
+                        if (!readNumber(reader->fp, &pixels[col].red) || 
+                            !readNumber(reader->fp, &pixels[col].green) ||
+                            !readNumber(reader->fp, &pixels[col].blue)) {
+                                return false;
+                        }
+                }
+                return samplesFit(pixels, width, reader->denominator);
+        }
+
+        const unsigned char *bytes = rawRow(reader);
+        if (bytes == NULL) {
+                return false;
+        }
+
+        if (reader->bytesPerSample == 1) {
+                for (unsigned col = 0; col < width; col++, bytes += 3) {
+                        pixels[col].red = bytes[0];
+                        pixels[col].green = bytes[1];
+                        pixels[col].blue = bytes[2];
+                }
+        } else {
+                /* two-byte samples are stored most significant byte first */
+                for (unsigned col = 0; col < width; col++, bytes += 6) {
+                        pixels[col].red = (bytes[0] << 8) | bytes[1];
+                        pixels[col].green = (bytes[2] << 8) | bytes[3];
+                        pixels[col].blue = (bytes[4] << 8) | bytes[5];
+                }
+        }
+
+        /* no sample can be above the largest maxval of its size */
+        unsigned largest = (reader->bytesPerSample == 1) ? ONE_BYTE_MAX : 
+                                                           PPM_MAX_DENOMINATOR;
+        return reader->denominator == largest || 
+               samplesFit(pixels, width, reader->denominator);
+}
+
+/********** PpmReader_readSamples ********
+ *
+ *  Reads the next row of the image into compact samples: red, green, and
+ *  blue for each pixel, one unsigned char each when the maxval is below 
+ *  256, otherwise one uint16_t each. Pixels past the given width are read
+ *  and dropped, so an odd last column can be cropped while reading
+ *
+ * Parameters:
+ *      PpmReader_T reader: the reader to read from
+ *      void *samples:      a buffer of at least 3 * width samples to fill
+ *      unsigned width:     the number of pixels to keep, at most the width
+ *                          of the image
+ *
+ * Return: 
+ *      true if a whole row was read, false if the image ended early or a
+ *      plain sample could not be parsed
+ *
+ * Expects
+ *      reader and samples to not be null
+ * 
+ * Notes:
+ *      Will CRE if reader or samples is null or width is too large
+ *      
+ ************************/
+bool PpmReader_readSamples(PpmReader_T reader, void *samples, unsigned width)
+{
+        assert(reader != NULL);
+        assert(samples != NULL);
+        assert(width <= reader->width);
+        unsigned char *narrow = samples;
+        uint16_t *wide = samples;
+        bool oneByte = (reader->bytesPerSample == 1);
+        size_t kept = (size_t)3 * width;
+
+        if (reader->plain) {
+                size_t count = (size_t)3 * reader->width;
+                for (size_t i = 0; i < count; i++) {
+                        unsigned sample;
+                        if (!readNumber(reader->fp, &sample)) {
+                                return false;
+                        }
+                        if (i < kept && oneByte) {
+                                narrow[i] = sample;
+                        } else if (i < kept) {
+                                wide[i] = sample;
+                        }
+                }
+                return true;
+        }
+
+        const unsigned char *bytes = rawRow(reader);
+        if (bytes == NULL) {
+                return false;
+        }
+        if (oneByte) {
+                memcpy(narrow, bytes, kept);
+        } else {
+                /* two-byte samples are stored most significant byte first */
+                for (size_t i = 0; i < kept; i++, bytes += 2) {
+                        wide[i] = (bytes[0] << 8) | bytes[1];
+                }
+        }
+        return true;
+}
+
+/********** PpmReader_bytesPerSample ********
+ *
+ *  Returns the size of each sample stored by PpmReader_readSamples
+ *
+ ************************/
+unsigned PpmReader_bytesPerSample(PpmReader_T reader)
+{
+        assert(reader != NULL);
+        return reader->bytesPerSample;
+}
+
+/********** PpmReader_viewable ********
+ *
+ *  Returns whether the rows of the image can be used in place: they can
+ *  when the image is raw, has one-byte samples, and is mapped
+ *
+ ************************/
+bool PpmReader_viewable(PpmReader_T reader)
+{
+        assert(reader != NULL);
+        return reader->mapped != NULL && reader->bytesPerSample == 1;
+}
+
+/********** PpmReader_viewRows ********
+ *
+ *  Takes the next rows of a viewable image without copying them
+ *
+ * Parameters:
+ *      PpmReader_T reader: the reader of a viewable image
+ *      unsigned rows:      the number of rows to take
+ *
+ * Return: 
+ *      the bytes of the rows, 3 * width per row, valid until the reader is
+ *      freed, or NULL if the image ended early
+ *
+ * Expects
+ *      reader to not be null and to be viewable
+ * 
+ * Notes:
+ *      Will CRE if reader is null or not viewable
+ *      
+ ************************/
+const unsigned char *PpmReader_viewRows(PpmReader_T reader, unsigned rows)
+{
+        assert(reader != NULL);
+        assert(PpmReader_viewable(reader));
+        return MappedInput_take(reader->mapped, 
+                                (size_t)3 * reader->width * rows);
+}
+
+/********** rawRow ********
+ *
+ *  Takes the next row of a raw image, from the mapping if the image is
+ *  mapped, otherwise by reading it into the row buffer
+ *
+ * Parameters:
+ *      PpmReader_T reader: the reader of a raw image
+ *
+ * Return: 
+ *      the bytes of the row, or NULL if the image ended early
+ *
+ ************************/
+static const unsigned char *rawRow(PpmReader_T reader)
+{
+        size_t rowSize = (size_t)3 * reader->bytesPerSample * reader->width;
+        if (reader->mapped != NULL) {
+                return MappedInput_take(reader->mapped, rowSize);
+        }
+        if (fread(reader->rowBytes, 1, rowSize, reader->fp) != rowSize) {
+                return NULL;
+        }
+        return reader->rowBytes;
+}
+
+/********** samplesFit ********
+ *
+ *  Checks a row of pixels against the maxval
+ *
+ * Parameters:
+ *      Pnm_rgb pixels:       the row
+ *      unsigned width:       the number of pixels in the row
+ *      unsigned denominator: the maxval
+ *
+ * Return: 
+ *      true if no sample is above the maxval
+ *
+ ************************/
+static bool samplesFit(Pnm_rgb pixels, unsigned width, unsigned denominator)
+{
+        for (unsigned col = 0; col < width; col++) {
+                if (pixels[col].red > denominator || 
+                    pixels[col].green > denominator ||
+                    pixels[col].blue > denominator) {
+                        return false;
+                }
+        }
+        return true;
+}
+
+/********** readNumber ********
+ *
+ *  Reads an unsigned decimal number from a PPM header or plain raster,
+ *  skipping any whitespace and comments in front of it
+ *
+ * Parameters:
+ *      FILE *fp:         the stream to read from
+ *      unsigned *number: where to store the number
+ *
+ * Return: 
+ *      true if a number was read, false if there was no number or it would
+ *      overflow an unsigned
+ *
+ * Expects
+ *      fp and number to not be null
+ * 
+ * Notes:
+ *      Does not consume the character that ends the number
+ *      
+ ************************/
+static bool readNumber(FILE *fp, unsigned *number)
+{
+        int c = skipSpaceAndComments(fp);
+        if (!isdigit(c)) {
+                return false;
+        }
+
+        unsigned value = 0;
+        while (isdigit(c)) {
+                unsigned digit = c - '0';
+                if (value > (UINT_MAX - digit) / 10) {
+                        return false;
+                }
+                value = value * 10 + digit;
+                c = getc(fp);
+        }
+
+        /* the number must be followed by whitespace, a comment, or EOF, 
+           which is left in the stream for the next read */
+        if (c != EOF) {
+                if (!isspace(c) && c != '#') {
+                        return false;
+                }
+                ungetc(c, fp);
+        }
+        *number = value;
+        return true;
+}
+
+/********** skipSpaceAndComments ********
+ *
+ *  Skips whitespace and '#' comments, which run to the end of the line
+ *
+ * Parameters:
+ *      FILE *fp: the stream to read from
+ *
+ * Return: 
+ *      The first character that is not whitespace or part of a comment,
+ *      or EOF
+ *
+ ************************/
+static int skipSpaceAndComments(FILE *fp)
+{
+        int c = getc(fp);
+        while (c == '#' || isspace(c)) {
+                if (c == '#') {
+                        while (c != '\n' && c != EOF) {
+                                c = getc(fp);
+                        }
+                }
+                c = getc(fp);
+        }
+        return c;
+}
@@ -0,0 +1,50 @@
+/*
+ *      ppmReader.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the ppmReader abstraction, which
+ *      parses the header of a plain (P3) or raw (P6) PPM image and then hands
+ *      its pixels out one row at a time. Only a single row is ever buffered,
+ *      so images of any height can be read in O(width) memory.
+ *
+ *      Malformed input is reported through return values rather than
+ *      checked runtime errors so that callers can decide how to fail.
+ */
+
+#ifndef PPM_READER
+#define PPM_READER
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "pnm.h"
+
+typedef struct PpmReader_T *PpmReader_T;
+
+/* returns NULL if fp does not start with a valid PPM header */
+PpmReader_T PpmReader_new(FILE *fp);
+void PpmReader_free(PpmReader_T *reader);
+
+unsigned PpmReader_width(PpmReader_T reader);
+unsigned PpmReader_height(PpmReader_T reader);
+unsigned PpmReader_denominator(PpmReader_T reader);
+
+/* fills in width pixels; returns false if the image ends too early or a
+   sample is above the maxval */
+bool PpmReader_readRow(PpmReader_T reader, Pnm_rgb pixels);
+
+/* fills in 3 * width compact samples of PpmReader_bytesPerSample bytes 
+   each, dropping the rest of the row; returns false if the image ends 
+   too early */
+bool PpmReader_readSamples(PpmReader_T reader, void *samples, 
+                           unsigned width);
+unsigned PpmReader_bytesPerSample(PpmReader_T reader);
+
+/* true for a raw image of one-byte samples in a mapped file, whose rows 
+   can be used in place */
+bool PpmReader_viewable(PpmReader_T reader);
+/* returns the next rows in place, valid until the reader is freed, or NULL
+   if the image ends early */
+const unsigned char *PpmReader_viewRows(PpmReader_T reader, unsigned rows);
+
+#endif
@@ -0,0 +1,250 @@
+/*
+ *      ppmWriter.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation for the ppmWriter abstraction.
+ *      Rows go into a buffer of at least CHUNK_BYTES and reach the stream
+ *      with one fwrite per chunk, which stdio passes straight to write() 
+ *      because a chunk is larger than its own buffer. Runs of rows that do
+ *      not fit in the buffer are written directly, without being copied. A 
+ *      write that comes up short marks the writer as failed, which 
+ *      PpmWriter_flush reports, so a caller that must carry on can tell a 
+ *      full disk from a finished image.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "assert.h"
+
+#include "readOrWrite.h"
+#include "ppmWriter.h"
+
+/* The smallest buffer rows are collected in before being written */
+static const size_t CHUNK_BYTES = 256 * 1024;
+
+/* PpmWriter_T struct that stores the stream and the rows not yet written */
+struct PpmWriter_T {
+        FILE *fp;
+        size_t rowSize;         /* 3 * width bytes */
+        unsigned rowsLeft;      /* rows the header promises, not yet given */
+        unsigned char *buffer;
+        size_t capacity;
+        size_t used;
+        bool failed;            /* a write came up short */
+};
+
+static void flush(PpmWriter_T writer);
+
+/********** PpmWriter_new ********
+ *
+ *  Writes the header of a raw PPM image and prepares to write its rows
+ *
+ * Parameters:
+ *      FILE *fp:             the stream to write to
+ *      unsigned width:       the width of the image
+ *      unsigned height:      the height of the image
+ *      unsigned denominator: the maxval of the image
+ *
+ * Return: 
+ *      A new PpmWriter_T, or NULL if its buffer cannot be allocated, in
+ *      which case nothing is written
+ *
+ * Expects
+ *      fp to not be null
+ *      denominator to be between 1 and 255 so that each sample is one byte
+ * 
+ * Notes:
+ *      Will CRE if fp is null or denominator is out of range
+ *      The caller must free the writer with PpmWriter_free
+ *      
+ ************************/
+PpmWriter_T PpmWriter_new(FILE *fp, unsigned width, unsigned height, 
+                          unsigned denominator)
+{
+        assert(fp != NULL);
+
+        PpmWriter_T writer = malloc(sizeof(*writer));
+        if (writer == NULL) {
+                return NULL;
+        }
+        writer->fp = fp;
+        writer->rowSize = (size_t)3 * width;
+        writer->rowsLeft = height;
+        writer->capacity = CHUNK_BYTES;
+        if (writer->capacity < 2 * writer->rowSize) {
+                writer->capacity = 2 * writer->rowSize;
+        }
+        writer->buffer = malloc(writer->capacity);
+        if (writer->buffer == NULL) {
+                free(writer);
+                return NULL;
+        }
+        writer->used = 0;
+        writer->failed = false;
+
+        writePpmHeader(fp, width, height, denominator);
+        return writer;
+}
+
+/********** PpmWriter_free ********
+ *
+ *  Writes any buffered rows and frees a writer
+ *
+ * Parameters:
+ *      PpmWriter_T *writer: a pointer to the writer to free
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      writer and *writer to not be null
+ * 
+ * Notes:
+ *      Will CRE if writer or *writer is null
+ *      
+ ************************/
+void PpmWriter_free(PpmWriter_T *writer)
+{
+        assert(writer != NULL && *writer != NULL);
+        flush(*writer);
+        free((*writer)->buffer);
+        free(*writer);
+        *writer = NULL;
+}
+
+/********** PpmWriter_rows ********
+ *
+ *  Makes room in the buffer for the next rows of the image, writing out
+ *  the buffered rows first if they are in the way
+ *
+ * Parameters:
+ *      PpmWriter_T writer: the writer
+ *      unsigned rows:      the number of rows to make room for
+ *
+ * Return: 
+ *      A pointer to rows * 3 * width bytes, to be filled in before the
+ *      writer is used again, or NULL if the buffer cannot grow to hold 
+ *      them
+ *
+ * Expects
+ *      writer to not be null
+ *      rows to be no more than the rows the header has left
+ * 
+ * Notes:
+ *      Will CRE if writer is null or there are too many rows
+ *      Two rows always fit, so only larger requests can return NULL
+ *      
+ ************************/
+unsigned char *PpmWriter_rows(PpmWriter_T writer, unsigned rows)
+{
+        assert(writer != NULL);
+        assert(rows <= writer->rowsLeft);
+        size_t size = rows * writer->rowSize;
+
+        if (writer->used + size > writer->capacity) {
+                flush(writer);
+        }
+        if (size > writer->capacity) {
+                unsigned char *buffer = realloc(writer->buffer, size);
+                if (buffer == NULL) {
+                        return NULL;
+                }
+                writer->buffer = buffer;
+                writer->capacity = size;
+        }
+
+        unsigned char *room = writer->buffer + writer->used;
+        writer->used += size;
+        writer->rowsLeft -= rows;
+        return room;
+}
+
+/********** PpmWriter_write ********
+ *
+ *  Writes rows that are already contiguous, copying them into the buffer
+ *  if they fit and writing them directly if they do not
+ *
+ * Parameters:
+ *      PpmWriter_T writer:         the writer
+ *      const unsigned char *bytes: the rows, 3 * width bytes each
+ *      unsigned rows:              the number of rows
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      writer and bytes to not be null
+ *      rows to be no more than the rows the header has left
+ * 
+ * Notes:
+ *      Will CRE if writer or bytes is null or there are too many rows
+ *      
+ ************************/
+void PpmWriter_write(PpmWriter_T writer, const unsigned char *bytes, 
+                     unsigned rows)
+{
+        assert(writer != NULL && bytes != NULL);
+        assert(rows <= writer->rowsLeft);
+        size_t size = rows * writer->rowSize;
+
+        if (writer->used + size <= writer->capacity) {
+                memcpy(writer->buffer + writer->used, bytes, size);
+                writer->used += size;
+        } else {
+                flush(writer);
+                if (fwrite(bytes, 1, size, writer->fp) != size) {
+                        writer->failed = true;
+                }
+        }
+        writer->rowsLeft -= rows;
+}
+
+/********** PpmWriter_flush ********
+ *
+ *  Writes the buffered rows and flushes the stream, so whatever reads the
+ *  stream sees every row given so far without waiting for a full chunk
+ *
+ * Parameters:
+ *      PpmWriter_T writer: the writer
+ *
+ * Return: 
+ *      true if every row given so far reached the stream, false if any 
+ *      write, now or earlier, came up short
+ *
+ * Expects
+ *      writer to not be null
+ * 
+ * Notes:
+ *      Will CRE if writer is null
+ *      Costs a write for every call, so callers that do not need rows to 
+ *      reach the stream early should leave the writing to the chunks
+ *      
+ ************************/
+bool PpmWriter_flush(PpmWriter_T writer)
+{
+        assert(writer != NULL);
+        flush(writer);
+        if (fflush(writer->fp) != 0) {
+                writer->failed = true;
+        }
+        return !writer->failed;
+}
+
+/********** flush ********
+ *
+ *  Writes the buffered rows to the stream and empties the buffer, marking
+ *  the writer as failed if the write comes up short
+ *
+ ************************/
+static void flush(PpmWriter_T writer)
+{
+        if (writer->used > 0) {
+                if (fwrite(writer->buffer, 1, writer->used, writer->fp) != 
+                    writer->used) {
+                        writer->failed = true;
+                }
+                writer->used = 0;
+        }
+}
@@ -0,0 +1,41 @@
+/*
+ *      ppmWriter.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the ppmWriter abstraction, which
+ *      writes a raw (P6) image with one byte per sample. The header is 
+ *      written once, and rows are collected into a large buffer that is
+ *      written a chunk at a time, unless the caller flushes them sooner. A 
+ *      decoder can ask for room for its next rows and decode straight into
+ *      the buffer.
+ */
+
+#ifndef PPM_WRITER
+#define PPM_WRITER
+
+#include <stdbool.h>
+#include <stdio.h>
+
+typedef struct PpmWriter_T *PpmWriter_T;
+
+/* writes the header; denominator must be at most 255. Returns NULL, having
+   written nothing, if the writer's buffer cannot be allocated */
+PpmWriter_T PpmWriter_new(FILE *fp, unsigned width, unsigned height, 
+                          unsigned denominator);
+/* writes any buffered rows and frees the writer; fp is left open */
+void PpmWriter_free(PpmWriter_T *writer);
+
+/* returns room for the next rows, 3 * width bytes each, which must be 
+   filled in before the writer is used again; NULL if more than two rows 
+   are asked for and the buffer cannot grow to hold them */
+unsigned char *PpmWriter_rows(PpmWriter_T writer, unsigned rows);
+/* writes rows that are already laid out contiguously */
+void PpmWriter_write(PpmWriter_T writer, const unsigned char *bytes, 
+                     unsigned rows);
+/* writes the buffered rows and flushes the stream, for a reader that 
+   should see each row as soon as it is decoded; returns false if any 
+   write so far came up short */
+bool PpmWriter_flush(PpmWriter_T writer);
+
+#endif
@@ -19,11 +19,24 @@
 #include "a2methods.h"
 #include "a2plain.h"
 #include "a2blocked.h"
+#include "a2methodsExt.h"
 #include <math.h>
 #include "stdbool.h"
 
+/* the diffSums struct is passed to addSquareDiff as its closure, holding
+   a sum for each row of the part of the images they share */
+struct diffSums {
+        Pnm_ppm image1;
+        Pnm_ppm image2;
+        unsigned width;
+        unsigned height;
+        double *rowSums;
+};
+
 static FILE *open_or_abort(char *fname, char *mode);
 double squareDiff(int col, int row, Pnm_ppm image1, Pnm_ppm image2);
+void addSquareDiff(int col, int row, A2Methods_UArray2 uarray2, 
+                   void *elem, void *cl);
 
 /********** main ********
  *
@@ -90,17 +103,18 @@ int main(int argc, char *argv[])
         unsigned imageWidth = (I->width > IPrime->width) ?
                               IPrime->width : I->width;
         
-        for (unsigned col = 0; col < imageWidth; col++) {
-                if (col >= imageWidth) {
-                        break;
-                }
-                for (unsigned row = 0; row < imageHeight; row++) {
-                        if (row >= imageHeight) {
-                                break;
-                        }
-                        sum += squareDiff(col, row, I, IPrime);
-                }
+        /* Sum each row on the shared scheduler, a band of rows per thread,
+           then add up the rows in order */
+        A2MethodsExt_T ext = A2Methods_ext(methods);
+        assert(ext != NULL);
+        struct diffSums sums = { I, IPrime, imageWidth, imageHeight, NULL };
+        sums.rowSums = calloc(imageHeight + 1, sizeof(double));
+        assert(sums.rowSums != NULL);
+        ext->map_parallel(I->pixels, addSquareDiff, &sums, A2_CONCURRENT);
+        for (unsigned row = 0; row < imageHeight; row++) {
+                sum += sums.rowSums[row];
         }
+        free(sums.rowSums);
 
         double result = sqrt(sum / (3 * imageHeight * imageWidth));
 
@@ -137,6 +151,39 @@ static FILE *open_or_abort(char *fname, char *mode)
         return input;
 }
 
+/********** addSquareDiff ********
+ *
+ * Purpose: an apply function to add the square difference of a pixel to
+ *          the sum for its row, if both images have the pixel
+ *
+ * Parameters:
+ *      int col:                   the column of the pixel
+ *      int row:                   the row of the pixel
+ *      A2Methods_UArray2 uarray2: (UNUSED) the pixels of the first image
+ *      void *elem:                (UNUSED) the pixel of the first image
+ *      void *cl:                  the diffSums struct
+ *
+ * Return: none
+ *
+ * Notes:
+ *      Will CRE if cl is null
+ *      Runs from several threads at once; the plain methods visit each 
+ *      row from one thread, so each row's sum has one writer
+ ************************/
+void addSquareDiff(int col, int row, A2Methods_UArray2 uarray2, 
+                   void *elem, void *cl)
+{
+        (void) uarray2;
+        (void) elem;
+        assert(cl != NULL);
+
+        struct diffSums *sums = cl;
+        if ((unsigned)col < sums->width && (unsigned)row < sums->height) {
+                sums->rowSums[row] += squareDiff(col, row, sums->image1, 
+                                                 sums->image2);
+        }
+}
+
 /********** squareDiff ********
  *
  * Purpose: to find the difference in the RGB values between the two
@@ -4,38 +4,34 @@
  *      arith assignment
  *
  *      This file contains the implementation for the reading or printing
- *      stages of compression and/or decompression. It also provides a function
- *      to trim edges from a PPM image array with an odd height or width.
+ *      stages of compression and/or decompression. Odd edges of PPM images
+ *      are cropped by ppmImage, so no image is ever trimmed here.
  *      
  */
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdbool.h>
 #include "stdint.h"
 #include "assert.h"
 
 #include "wordConversions.h"
 #include "bitpack.h"
 #include "readOrWrite.h"
+#include "ppmWriter.h"
+#include "fusedConversions.h"
+#include "codeword.h"
+#include "a2methodsExt.h"
 
-/* Define some global ints to represente information about the codeword bits
-   that assist in big-endian iteration */
-const int CODEWORD_SIZE = 32; /* Define codeword size hence 32-bit uint */
-const int BYTE_SIZE = 8; /* Define a global variable for the size of a byte */
-const int BIGGEST_ENDIAN = 24; /* Starting point for big-endianness */
-const int LITTLEST_ENDIAN = 0; /* Ending point for big-endianness */
-
+/* The number of codewords serialized for each fwrite */
+#define WRITE_CHUNK_WORDS 8192
 
 /* Compression Functions */
-Pnm_ppm makeNewImage(Pnm_ppm image, A2Methods_T methods, int height, 
-                     int width);
-void writeContents(int col, int row, A2Methods_UArray2 uarray2, 
-                   void *elem, void *cl);
+static inline void storeBigEndian(unsigned char *bytes, uint32_t word);
 
 
 /* Decompression Functions */ 
-void readWord(int col, int row, A2Methods_UArray2 uarray2, 
-              void *elem, void *cl);
+static inline uint32_t loadBigEndian(const unsigned char *bytes);
 
 /****************************************************************
 *                                                               *
@@ -44,193 +40,133 @@ void readWord(int col, int row, A2Methods_UArray2 uarray2,
 *****************************************************************/
 
 
-/********** trim ********
+/********** writeCompressed ********
  *
- *  Trims a given Pnm_ppm image to have an even width and height 
+ *  To write the given compressed file to disk in big-endian order
  *
  * Parameters:
- *      Pnm_ppm image:         a Pnm_ppm struct with the information of the
- *                             original image
- *      A2Methods_T methods:   the methods that the image should use
+ *      A2Methods_UArray2 uarray2:  a uarray2 of 32-bit codewords
+ *                                  the original image
+ *      A2Methods_T methods:        the methods that the image should use
+ *      unsigned height:            the height of the compressed file
+ *      unsigned width:             the width of the compressed file
  *
  * Return: 
- *      The Pnm_ppm image that was passed in except with trimmed height and
- *      width
+ *      none
  *
  * Expects
- *      image to not be null
- *      methods to not be null
+ *      width and height to be even numbers
  * 
  * Notes:
- *      Will CRE if the Pnm_ppm image is null
- *      Will CRE if methods are null
+ *      Will CRE if width and height are not even numbers
  *      
  ************************/
-Pnm_ppm trim(Pnm_ppm image, A2Methods_T methods)
+void writeCompressed(A2Methods_UArray2 uarray2, A2Methods_T methods, 
+                     unsigned width, unsigned height)
 {
-        /* Check our parameters */
-        assert(image != NULL);
-        assert(methods != NULL);
-        int height = image->height;
-        int width = image->width;
-
-        /* If height and width are both even, return the original image */
-        if (height % 2 == 0 && width % 2 == 0) {
-                return image;
-        }
+        /* Write the header to disk and make sure width/height are even */
+        writeCompressedHeader(stdout, width, height);
 
-        /* Modify the height and width into local variables to even numbers */
-        if (height % 2 != 0) {
-                height -= 1;
-        }         
-        if (width % 2 != 0) {
-                width -= 1;
+        /* Gather each row of codewords and write it to disk in bulk */
+        unsigned count = methods->width(uarray2);
+        unsigned rows = methods->height(uarray2);
+        uint32_t *buffer = malloc((count + 1) * sizeof(*buffer));
+        assert(buffer != NULL);
+        for (unsigned row = 0; row < rows; row++) {
+                uint32_t *words = A2Methods_row(methods, uarray2, row);
+                if (words == NULL) {
+                        A2Methods_getRow(methods, uarray2, row, buffer);
+                        words = buffer;
+                }
+                writeWordRow(stdout, words, count);
         }
-        
-        /* Make our new image using a helper function to copy over data */
-        Pnm_ppm newImage = makeNewImage(image, methods, height, width);
-
-        /* Free the original image and return the new modified Pnm_ppm 
-           NOTE: the modified Pnm_ppm newImage is freed in compress40.c */
-        Pnm_ppmfree(&image);
-
-        return newImage;
+        free(buffer);
 }
 
-/********** makeNewImage ********
+/********** writeCompressedHeader ********
  *
- *  Helper function for the trim function to copy over all of the pixels
- *  from the original image to a new image minus the trimmed height/width
+ *  To write the header of a compressed file to disk
  *
  * Parameters:
- *      Pnm_ppm image:         a Pnm_ppm struct with the information of the
- *                             original image
- *      A2Methods_T methods:   the methods that the image should use
- *      int height:            the trimmed height
- *      int width:             the trimmed width
+ *      FILE *fp:                   the file to write to
+ *      unsigned width:             the width of the compressed file
+ *      unsigned height:            the height of the compressed file
  *
  * Return: 
- *      A new Pnm_ppm struct with the same data as the original image
- *      minues the columns and rows that were trimmed 
+ *      none
  *
  * Expects
- *      image to not be null
- *      methods to not be null
- *      height and width to be the trimmed values if applicable
+ *      width and height to be even numbers
  * 
  * Notes:
- *      Will CRE if malloc fails for newImage
- *      Will CRE if the Pnm_ppm image is null
- *      Will CRE if methods are null
- *      Will CRE if the creation of the uarray2 fails
+ *      Will CRE if width and height are not even numbers
  *      
  ************************/
-Pnm_ppm makeNewImage(Pnm_ppm image, A2Methods_T methods, int height, int width)
+void writeCompressedHeader(FILE *fp, unsigned width, unsigned height)
 {
-        /* Malloc space for our newImage ppm */
-        Pnm_ppm newImage = malloc(sizeof(*newImage));
-        assert(newImage != NULL);
-        
-        /* Set all the header variables before populating the pixels */
-        newImage->height = height;
-        newImage->width = width;
-        newImage->denominator = image->denominator;
-        newImage->methods = image->methods;
-        
-        /* Make our new pixels uarray2 */
-        A2Methods_UArray2 uarray2 = methods->new(width, 
-                                                 height, 
-                                                 sizeof(struct Pnm_rgb));
-        assert(uarray2 != NULL);
-        newImage->pixels = uarray2;
-        
-        /*  Copy over all the RGBs into the new pixels from the orig image */
-        Pnm_rgb newPixel;
-        Pnm_rgb originalPixel;
-        for (int row = 0; row < height; row++) {
-                for(int col = 0; col < width; col++) {
-                        newPixel = methods->at(newImage->pixels, col, row);
-                        originalPixel = methods->at(image->pixels, col, row);
-                        newPixel->red = originalPixel->red;
-                        newPixel->green = originalPixel->green;
-                        newPixel->blue = originalPixel->blue;
-                }
-        }
-
-        return newImage;        
+        fprintf(fp, "COMP40 Compressed image format %u\n%u %u", 
+                (unsigned)CODEWORD_FORMAT, width, height);
+        fprintf(fp, "\n");
+        assert(width % 2 == 0);
+        assert(height % 2 == 0);
 }
 
-/********** writeCompressed ********
+/********** writeWordRow ********
  *
- *  To write the given compressed file to disk in big-endian order
+ *  To write one row of codewords, or several consecutive rows, to disk in
+ *  big-endian order, for encoders that produce the compressed image a row 
+ *  at a time
  *
  * Parameters:
- *      A2Methods_UArray2 uarray2:  a uarray2 of 32-bit codewords
- *                                  the original image
- *      A2Methods_T methods:        the methods that the image should use
- *      unsigned height:            the height of the compressed file
- *      unsigned width:             the width of the compressed file
+ *      FILE *fp:                   the file to write to
+ *      uint32_t *words:            the codewords of the row
+ *      size_t count:               the number of codewords in the row
  *
  * Return: 
  *      none
  *
  * Expects
- *      width and height to be even numbers
+ *      fp and words to not be null
  * 
  * Notes:
- *      Will CRE if width and height are not even numbers
+ *      Will CRE if fp or words is null
  *      
  ************************/
-void writeCompressed(A2Methods_UArray2 uarray2, A2Methods_T methods, 
-                     unsigned width, unsigned height)
+void writeWordRow(FILE *fp, uint32_t *words, size_t count)
 {
-        /* Write the header to disk and make sure width/height are even */
-        printf("COMP40 Compressed image format 2\n%u %u", width, height);
-        printf("\n");
-        assert(width % 2 == 0);
-        assert(height % 2 == 0);
+        assert(fp != NULL);
+        assert(words != NULL);
 
-        /* Map through the uarray2 of codewords and write them to disk */
-        methods->map_row_major(uarray2, writeContents, NULL);
+        /* Serialize a chunk at a time and hand each chunk to stdio whole */
+        unsigned char bytes[4 * WRITE_CHUNK_WORDS];
+        while (count > 0) {
+                size_t chunk = (count < WRITE_CHUNK_WORDS) 
+                                 ? count : WRITE_CHUNK_WORDS;
+                for (unsigned i = 0; i < chunk; i++) {
+                        storeBigEndian(&bytes[4 * i], words[i]);
+                }
+                fwrite(bytes, 4, chunk, fp);
+                words += chunk;
+                count -= chunk;
+        }
 }
 
-/********** writeContents ********
+/********** storeBigEndian ********
  *
- *  An apply function to write the given codeword to disk in big-endian order
+ *  To store a codeword as four bytes in big-endian order; compilers turn
+ *  the shifts into a single byte swap and store
  *
  * Parameters:
- *      int col:                    (UNUSED) the current col in uarray2
- *      int row:                    (UNUSED) the current row in uarray2
- *      A2Methods_UArray2 uarray:   (UNUSED) the uarray2 of codewords
- *      void *elem:                 the current codeword in the uarray2
- *      void *cl:                   (UNUSED) the closure variable
- *                         
- *
- * Return: 
- *      none
+ *      unsigned char *bytes: where to store the four bytes
+ *      uint32_t word:        the codeword to store
  *
- * Expects
- *      void *elem to be a pointer to a 32-bit packed codeword
- * 
- * Notes:
- *      None
- *      
  ************************/
-void writeContents(int col, int row, A2Methods_UArray2 uarray2, 
-                   void *elem, void *cl)
+static inline void storeBigEndian(unsigned char *bytes, uint32_t word)
 {
-        (void) col;
-        (void) row;
-        (void) uarray2;
-        (void) cl;
-        
-        /* Cast the elem passed in as a 32-bit signed integer */
-        int32_t word = *(int32_t *)elem;
-        
-        /* Write the codeword to disk using putchar in big-endian order */
-        for (int i = BIGGEST_ENDIAN; i >= LITTLEST_ENDIAN; i -= BYTE_SIZE) {
-                putchar(Bitpack_getu(word, BYTE_SIZE, i));
-        }
+        bytes[0] = (unsigned char)(word >> 24);
+        bytes[1] = (unsigned char)(word >> 16);
+        bytes[2] = (unsigned char)(word >> 8);
+        bytes[3] = (unsigned char)word;
 }
 
 
@@ -260,8 +196,9 @@ void writeContents(int col, int row, A2Methods_UArray2 uarray2,
  * Notes:
  *      Will CRE if fp is null
  *      Will CRE if methods are null
- *      Will CRE if fscanf does not return 2
+ *      Will CRE if the header is malformed or is for another format
  *      Will CRE if getc does not return a newline
+ *      Exits with a message if the file holds too few codewords
  *      
  ************************/
 A2Methods_UArray2 readCompressed(FILE *fp, A2Methods_T methods)
@@ -272,75 +209,295 @@ A2Methods_UArray2 readCompressed(FILE *fp, A2Methods_T methods)
 
         /* Read in the height and width and store them using spec code */
         unsigned height, width;
-        int read = fscanf(fp, "COMP40 Compressed image format 2\n%u %u", 
-                          &width, &height);
-        assert(read == 2);
-        int c = getc(fp);
-        assert(c == '\n');
+        readCompressedHeader(fp, &width, &height);
         
         /* Make a new uarray2 that will contain codewords that has half the
            original width and height */
         A2Methods_UArray2 wordsUArray2 = methods->new(width / 2, height / 2, 
                                                       sizeof(uint32_t));
-        /* Map through this new uarray2 to insert the words */
-        methods->map_default(wordsUArray2, readWord, fp);
-       
+        /* Read the words a row at a time, from the mapped file if it can
+           be mapped, and store them in the uarray2 */
+        MappedInput_T mapped = MappedInput_new(fp);
+        unsigned count = width / 2;
+        uint32_t *buffer = malloc((count + 1) * sizeof(*buffer));
+        assert(buffer != NULL);
+        for (unsigned row = 0; row < height / 2; row++) {
+                uint32_t *words = A2Methods_row(methods, wordsUArray2, row);
+                if (!takeWordRow(fp, mapped, words != NULL ? words : buffer,
+                                 count)) {
+                        exitTruncated();
+                }
+                if (words == NULL) {
+                        A2Methods_setRow(methods, wordsUArray2, row, buffer);
+                }
+        }
+        free(buffer);
+        if (mapped != NULL) {
+                MappedInput_free(&mapped);
+        }
+
         return wordsUArray2;
 }
 
-/********** readWord ********
+/********** readCompressedHeader ********
  *
- *  An apply function for readCompresssed to read in an individual codeword
+ *  To read the header of a compressed file
  *
  * Parameters:
- *      int col:                    (UNUSED) the current col in uarray2
- *      int row:                    (UNUSED) the current row in uarray2
- *      A2Methods_UArray2 uarray:   (UNUSED) the uarray2 of codewords
- *      void *elem:                 the current codeword in the uarray2
- *      void *cl:                   the closure variable representing the
- *                                  file pointer to read in from
+ *      FILE *fp:         a pointer to the file containing compressed 
+ *                        32-bit codewords
+ *      unsigned *width:  where to store the width of the image
+ *      unsigned *height: where to store the height of the image
  *
  * Return: 
  *      none
  *
  * Expects
- *      elem to be a pointer to a 32-bit codeword and not null
- *      closure to not be null
+ *      fp, width, and height to not be null
+ *      
+ * Notes:
+ *      Will CRE if fp, width, or height is null
+ *      Will CRE if the header is malformed or is for another format
+ *      Will CRE if getc does not return a newline
+ *      Leaves fp positioned at the first codeword
+ *      
+ ************************/
+void readCompressedHeader(FILE *fp, unsigned *width, unsigned *height)
+{
+        bool read = scanCompressedHeader(fp, width, height);
+        assert(read);
+}
+
+/********** scanCompressedHeader ********
+ *
+ *  To read the header of a compressed file, reporting a malformed header
+ *  instead of failing, for callers that must carry on to other files
+ *
+ * Parameters:
+ *      FILE *fp:         a pointer to the file containing compressed 
+ *                        32-bit codewords
+ *      unsigned *width:  where to store the width of the image
+ *      unsigned *height: where to store the height of the image
+ *
+ * Return: 
+ *      true if the header was read, false if it is malformed or was
+ *      written with a layout other than CODEWORD_FORMAT
+ *
+ * Expects
+ *      fp, width, and height to not be null
  *      
  * Notes:
- *      Will CRE if cl is null
- *      Will CRE if elem is null
+ *      Will CRE if fp, width, or height is null
+ *      Leaves fp positioned at the first codeword when the header is valid
  *      
  ************************/
-void readWord(int col, int row, A2Methods_UArray2 uarray2, 
-              void *elem, void *cl)
+bool scanCompressedHeader(FILE *fp, unsigned *width, unsigned *height)
 {
-        (void) col;
-        (void) row;
-        (void) uarray2;
+        assert(fp != NULL);
+        assert(width != NULL && height != NULL);
 
-        /* Assert our parameters */
-        assert(elem != NULL);
-        assert(cl != NULL);
+        /* the format records the layout the codewords were written with,
+           which must be the one this program was built with */
+        unsigned format = 0;
+        int read = fscanf(fp, "COMP40 Compressed image format %u\n%u %u", 
+                          &format, width, height);
+        return read == 3 && format == CODEWORD_FORMAT && getc(fp) == '\n';
+}
 
-        /* Cast our closure variable to a file pointer to then read from */
-        FILE *fp = (FILE *)cl;
-        
-        /* Cast our elem variable to a uint32_t to store the codeword */
-        uint32_t *finalWord = (uint32_t *)elem;
-
-        /* Define an byte to then be read in and a word of all 0s to help 
-           with the process of reading in the codeword*/
-        int byte;
-        uint32_t word = (uint32_t)0;
-
-        /* Assign the current elemtn in the array to be the codeword 
-           which is read in big-endian */
-        for (int i = BIGGEST_ENDIAN; i >= LITTLEST_ENDIAN; i -= BYTE_SIZE) {
-                byte = getc(fp);
-                assert(byte != EOF);
-                word = Bitpack_newu(word, BYTE_SIZE, i, byte);
+/********** readWordRow ********
+ *
+ *  To read one row of codewords, or several consecutive rows, stored in
+ *  big-endian order, for decoders that consume the compressed image a row 
+ *  at a time
+ *
+ * Parameters:
+ *      FILE *fp:        a pointer to the file to read from
+ *      uint32_t *words: where to store the codewords of the row
+ *      size_t count:    the number of codewords in the row
+ *
+ * Return: 
+ *      true if the whole row was read, false if the file ended first
+ *
+ * Expects
+ *      fp and words to not be null
+ *      
+ * Notes:
+ *      Will CRE if fp or words is null
+ *      
+ ************************/
+bool readWordRow(FILE *fp, uint32_t *words, size_t count)
+{
+        assert(fp != NULL);
+        assert(words != NULL);
+
+        /* Read the whole row at once, then swap each word into place */
+        if (fread(words, 4, count, fp) != count) {
+                return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+                words[i] = loadBigEndian((unsigned char *)&words[i]);
+        }
+        return true;
+}
+
+/********** takeWordRow ********
+ *
+ *  To take one row of codewords, or several consecutive rows, from a mapped
+ *  compressed file, or to read it from the file when it is not mapped
+ *
+ * Parameters:
+ *      FILE *fp:             a pointer to the file to read from
+ *      MappedInput_T mapped: the mapping of fp, or NULL to read through fp
+ *      uint32_t *words:      where to store the codewords of the row
+ *      size_t count:         the number of codewords in the row
+ *
+ * Return: 
+ *      true if the whole row was read, false if the file ended first
+ *
+ * Expects
+ *      fp and words to not be null
+ *      
+ * Notes:
+ *      Will CRE if fp or words is null
+ *      
+ ************************/
+bool takeWordRow(FILE *fp, MappedInput_T mapped, uint32_t *words, 
+                 size_t count)
+{
+        if (mapped == NULL) {
+                return readWordRow(fp, words, count);
+        }
+        assert(words != NULL);
+
+        const unsigned char *bytes = MappedInput_take(mapped, 4 * count);
+        if (bytes == NULL) {
+                return false;
         }
-        /* Set our element equal to the word we have read in */
-        *finalWord = word;
-}
\ No newline at end of file
+        for (size_t i = 0; i < count; i++) {
+                words[i] = loadBigEndian(&bytes[4 * i]);
+        }
+        return true;
+}
+
+/********** loadBigEndian ********
+ *
+ *  To load a codeword stored as four bytes in big-endian order; compilers
+ *  turn the shifts into a single load and byte swap
+ *
+ * Parameters:
+ *      const unsigned char *bytes: the four bytes of the codeword
+ *
+ * Return: 
+ *      the codeword
+ *
+ ************************/
+static inline uint32_t loadBigEndian(const unsigned char *bytes)
+{
+        return (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | 
+               (uint32_t)bytes[2] << 8 | (uint32_t)bytes[3];
+}
+
+/********** exitTruncated ********
+ *
+ *  To report a compressed image whose codewords end early and exit, 
+ *  rather than failing an assertion partway through decoding
+ *
+ ************************/
+void exitTruncated(void)
+{
+        fprintf(stderr, "Compressed image is truncated: it holds fewer "
+                "codewords than its header promises\n");
+        exit(EXIT_FAILURE);
+}
+
+/********** exitWriteFailed ********
+ *
+ *  To report that the decompressed image could not be written, because 
+ *  the reader of the output went away or the disk is full, and exit 
+ *  rather than keep decoding rows that go nowhere
+ *
+ ************************/
+void exitWriteFailed(void)
+{
+        fprintf(stderr, "Cannot write the decompressed image\n");
+        exit(EXIT_FAILURE);
+}
+
+/********** writePpmHeader ********
+ *
+ *  To write the header of a raw (P6) PPM image to disk, for decoders that
+ *  write the decompressed pixels themselves instead of through Pnm_ppmwrite
+ *
+ * Parameters:
+ *      FILE *fp:             the file to write to
+ *      unsigned width:       the width of the decompressed image
+ *      unsigned height:      the height of the decompressed image
+ *      unsigned denominator: the maxval of the decompressed image
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      denominator to be between 1 and 255 so that each sample is one byte
+ *      
+ * Notes:
+ *      Will CRE if denominator is 0 or greater than 255
+ *      
+ ************************/
+void writePpmHeader(FILE *fp, unsigned width, unsigned height, 
+                    unsigned denominator)
+{
+        assert(denominator > 0 && denominator <= 255);
+        fprintf(fp, "P6\n%u %u\n%u\n", width, height, denominator);
+}
+
+/********** writeDecompressed ********
+ *
+ *  To write a uarray2 of RGB pixels to disk as a raw (P6) PPM image
+ *
+ * Parameters:
+ *      A2Methods_UArray2 uarray2: a uarray2 of Pnm_rgb pixels
+ *      A2Methods_T methods:       the methods that uarray2 uses
+ *      unsigned denominator:      the maxval of the pixels
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      uarray2 and methods to not be null
+ *      denominator to be between 1 and 255 so that each sample is one byte
+ *      
+ * Notes:
+ *      Will CRE if uarray2 or methods is null
+ *      Will CRE if denominator is 0 or greater than 255
+ *      Will CRE if methods is not the plain or blocked suite
+ *      
+ ************************/
+void writeDecompressed(A2Methods_UArray2 uarray2, A2Methods_T methods, 
+                       unsigned denominator)
+{
+        assert(uarray2 != NULL);
+        assert(methods != NULL);
+
+        A2MethodsExt_T ext = A2Methods_ext(methods);
+        assert(ext != NULL);
+
+        int width = methods->width(uarray2);
+        int height = methods->height(uarray2);
+        PpmWriter_T writer = PpmWriter_new(stdout, width, height, 
+                                           denominator);
+        assert(writer != NULL);
+
+        /* Fill in one row of bytes at a time, a span of contiguous pixels
+           at a time */
+        int length;
+        for (int row = 0; row < height; row++) {
+                unsigned char *bytes = PpmWriter_rows(writer, 1);
+                for (int col = 0; col < width; col += length) {
+                        Pnm_rgb pixels = ext->span(uarray2, col, row, 
+                                                   &length);
+                        storePixels(pixels, length, bytes + 3 * col);
+                }
+        }
+        PpmWriter_free(&writer);
+}
@@ -13,15 +13,30 @@
 #ifndef READ_OR_WRITE
 #define READ_OR_WRITE
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "pnm.h"
+#include "mappedInput.h"
 
 /* Compression */
-Pnm_ppm trim(Pnm_ppm image, A2Methods_T methods);
 void writeCompressed(A2Methods_UArray2 uarray2, A2Methods_T methods, 
                      unsigned width, unsigned height);
+void writeCompressedHeader(FILE *fp, unsigned width, unsigned height);
+void writeWordRow(FILE *fp, uint32_t *words, size_t count);
 
 /* Decompression */
 A2Methods_UArray2 readCompressed(FILE *fp, A2Methods_T methods);
+void readCompressedHeader(FILE *fp, unsigned *width, unsigned *height);
+bool scanCompressedHeader(FILE *fp, unsigned *width, unsigned *height);
+bool readWordRow(FILE *fp, uint32_t *words, size_t count);
+bool takeWordRow(FILE *fp, MappedInput_T mapped, uint32_t *words, 
+                 size_t count);
+void exitTruncated(void);
+void exitWriteFailed(void);
+void writePpmHeader(FILE *fp, unsigned width, unsigned height, 
+                    unsigned denominator);
+void writeDecompressed(A2Methods_UArray2 uarray2, A2Methods_T methods, 
+                       unsigned denominator);
 
 #undef READ_OR_WRITE
 #endif
\ No newline at end of file
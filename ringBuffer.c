@@ -0,0 +1,176 @@
+/*
+ *      ringBuffer.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation for the Ring abstraction. The
+ *      producer only writes tail and the consumer only writes head, and both
+ *      count up forever, so a release store of one and an acquire load of 
+ *      the other are all the synchronization needed. head and tail live on 
+ *      separate cache lines so the two threads do not fight over one line.
+ */
+
+#include <stdlib.h>
+#include "assert.h"
+
+#include "ringBuffer.h"
+
+/* The size of a cache line, to keep head and tail apart */
+#define CACHE_LINE 64
+
+struct Ring_T {
+        unsigned head;                   /* next slot to pop, by consumer */
+        char headPad[CACHE_LINE - sizeof(unsigned)];
+        unsigned tail;                   /* next slot to push, by producer */
+        char tailPad[CACHE_LINE - sizeof(unsigned)];
+        unsigned mask;                   /* capacity - 1 */
+        void **items;
+};
+
+/********** Ring_new ********
+ *
+ *  Makes an empty ring
+ *
+ * Parameters:
+ *      unsigned capacity: the fewest items the ring must be able to hold
+ *
+ * Return: 
+ *      A new Ring_T that holds capacity items rounded up to a power of two
+ *
+ * Expects
+ *      capacity to be between 1 and 2^31
+ * 
+ * Notes:
+ *      Will CRE if capacity is out of range or memory allocation fails
+ *      The caller must free the ring with Ring_free
+ *      
+ ************************/
+Ring_T Ring_new(unsigned capacity)
+{
+        assert(capacity > 0 && capacity <= (1u << 31));
+
+        unsigned size = 1;
+        while (size < capacity) {
+                size *= 2;
+        }
+
+        Ring_T ring = malloc(sizeof(*ring));
+        assert(ring != NULL);
+        ring->head = 0;
+        ring->tail = 0;
+        ring->mask = size - 1;
+        ring->items = malloc(size * sizeof(*ring->items));
+        assert(ring->items != NULL);
+
+        return ring;
+}
+
+/********** Ring_free ********
+ *
+ *  Frees a ring; any items still in it are not freed
+ *
+ * Parameters:
+ *      Ring_T *ring: a pointer to the ring to free
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      ring and *ring to not be null
+ *      neither thread to be using the ring any longer
+ * 
+ ************************/
+void Ring_free(Ring_T *ring)
+{
+        assert(ring != NULL && *ring != NULL);
+        free((*ring)->items);
+        free(*ring);
+        *ring = NULL;
+}
+
+/********** Ring_capacity ********
+ *
+ *  Returns the number of items the ring can hold
+ *
+ ************************/
+unsigned Ring_capacity(Ring_T ring)
+{
+        assert(ring != NULL);
+        return ring->mask + 1;
+}
+
+/********** Ring_depth ********
+ *
+ *  Returns the number of items in the ring. Called from the producer or 
+ *  consumer it is exact for that side; from any other thread it is only a
+ *  snapshot
+ *
+ ************************/
+unsigned Ring_depth(Ring_T ring)
+{
+        assert(ring != NULL);
+        unsigned tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        unsigned head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        return tail - head;
+}
+
+/********** Ring_push ********
+ *
+ *  Adds an item to the ring, if there is room
+ *
+ * Parameters:
+ *      Ring_T ring: the ring to push onto
+ *      void *item:  the item to push
+ *
+ * Return: 
+ *      true if the item was added, false if the ring was full
+ *
+ * Expects
+ *      to only ever be called from the ring's one producer thread
+ *
+ ************************/
+bool Ring_push(Ring_T ring, void *item)
+{
+        assert(ring != NULL);
+        unsigned tail = ring->tail;
+        unsigned head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if (tail - head > ring->mask) {
+                return false;
+        }
+
+        ring->items[tail & ring->mask] = item;
+        /* publish the item before the consumer can see the new tail */
+        __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+        return true;
+}
+
+/********** Ring_pop ********
+ *
+ *  Removes the oldest item from the ring, if there is one
+ *
+ * Parameters:
+ *      Ring_T ring:  the ring to pop from
+ *      void **item:  where to store the item
+ *
+ * Return: 
+ *      true if an item was removed, false if the ring was empty
+ *
+ * Expects
+ *      to only ever be called from the ring's one consumer thread
+ *
+ ************************/
+bool Ring_pop(Ring_T ring, void **item)
+{
+        assert(ring != NULL);
+        assert(item != NULL);
+        unsigned head = ring->head;
+        unsigned tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+                return false;
+        }
+
+        *item = ring->items[head & ring->mask];
+        /* free the slot only after the item has been read out of it */
+        __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+        return true;
+}
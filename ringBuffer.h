@@ -0,0 +1,32 @@
+/*
+ *      ringBuffer.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the Ring abstraction, a bounded
+ *      lock-free queue of pointers between exactly one producer thread and
+ *      exactly one consumer thread. Neither side ever blocks: a push to a 
+ *      full ring or a pop from an empty one just returns false.
+ */
+
+#ifndef RING_BUFFER
+#define RING_BUFFER
+
+#include <stdbool.h>
+
+typedef struct Ring_T *Ring_T;
+
+/* capacity is rounded up to a power of two */
+Ring_T Ring_new(unsigned capacity);
+void Ring_free(Ring_T *ring);
+
+unsigned Ring_capacity(Ring_T ring);
+/* the number of items queued; exact only from the producer or consumer */
+unsigned Ring_depth(Ring_T ring);
+
+/* producer only */
+bool Ring_push(Ring_T ring, void *item);
+/* consumer only */
+bool Ring_pop(Ring_T ring, void **item);
+
+#endif
@@ -0,0 +1,306 @@
+/*
+ *      sharedScheduler.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation of the shared Scheduler. A
+ *      call to SharedScheduler_bands is a job: its bands are handed out one
+ *      at a time, under the job's lock, to the calling thread and to a few
+ *      helper tasks on the pool, which all take bands until none are left.
+ *      The caller waits only for the bands to finish, never for a helper
+ *      to start, so a job finishes even when every worker is busy. The job
+ *      is freed by whichever of the caller and the helpers lets go of it
+ *      last, since a helper may start after the caller has returned.
+ */
+
+/* sysconf is POSIX, not C99 */
+#define _POSIX_C_SOURCE 200112L
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "assert.h"
+
+#include "sharedScheduler.h"
+
+/* How many bands a job is split into for each thread that can run one,
+   so that threads that finish early can take over the rest */
+static const unsigned BANDS_PER_THREAD = 4;
+
+static Scheduler_T shared = NULL;
+static unsigned processors = 1;
+static pthread_once_t startOnce = PTHREAD_ONCE_INIT;
+static pthread_once_t countOnce = PTHREAD_ONCE_INIT;
+
+/* The most threads that may work on one job, or 0 for one per processor */
+static unsigned threadLimit = 0;
+
+/* A call to SharedScheduler_bands, shared by its caller and helpers */
+struct bandJob {
+        pthread_mutex_t lock;   /* protects everything below */
+        pthread_cond_t allDone;
+        unsigned count;         /* the units to split into bands */
+        unsigned bands;
+        unsigned next;          /* the next band to hand out */
+        unsigned finished;      /* bands that have been run */
+        unsigned holders;       /* the caller and helpers using the job */
+        void (*run)(unsigned first, unsigned last, void *cl);
+        void *cl;
+};
+
+static void startShared(void);
+static void countProcessors(void);
+static unsigned jobThreads(void);
+static void runBands(struct bandJob *job);
+static void helpJob(void *vjob);
+static void letGo(struct bandJob *job);
+
+/********** startShared ********
+ *
+ *  Starts the shared scheduler with a worker for each thread a job may use
+ *  but one, which is left for the threads that call SharedScheduler_bands
+ *
+ * Notes:
+ *      Runs once, through pthread_once
+ *      Will CRE if the scheduler cannot be started
+ *
+ ************************/
+static void startShared(void)
+{
+        unsigned threads = jobThreads();
+        shared = Scheduler_new((threads > 1) ? threads - 1 : 1);
+}
+
+/********** countProcessors ********
+ *
+ *  Counts the online processors
+ *
+ * Notes:
+ *      Runs once, through pthread_once
+ *
+ ************************/
+static void countProcessors(void)
+{
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        processors = (count < 1) ? 1 : count;
+}
+
+/********** jobThreads ********
+ *
+ *  Returns how many threads, the caller's included, may work on one job:
+ *  one per online processor, but no more than the limit, if there is one
+ *
+ ************************/
+static unsigned jobThreads(void)
+{
+        pthread_once(&countOnce, countProcessors);
+        if (threadLimit != 0 && threadLimit < processors) {
+                return threadLimit;
+        }
+        return processors;
+}
+
+/********** SharedScheduler_get ********
+ *
+ *  Returns the shared scheduler, starting it the first time
+ *
+ * Parameters:
+ *      none
+ *
+ * Return:
+ *      The shared Scheduler_T, which lives until the process exits
+ *
+ * Notes:
+ *      May be called from any thread
+ *      The scheduler must not be freed, and Scheduler_wait on it waits for
+ *      every other user's tasks too
+ *
+ ************************/
+Scheduler_T SharedScheduler_get(void)
+{
+        pthread_once(&startOnce, startShared);
+        return shared;
+}
+
+/********** SharedScheduler_limit ********
+ *
+ *  Caps the number of threads that work on each call to 
+ *  SharedScheduler_bands, so a program can hold the shared scheduler to 
+ *  the thread count it was asked to use
+ *
+ * Parameters:
+ *      unsigned threads: the most threads, the caller's included, that may
+ *                        work on one call; 1 runs every call on its caller
+ *
+ * Return:
+ *      none
+ *
+ * Expects
+ *      threads to be at least 1
+ *      no other thread to be using the shared scheduler
+ *
+ * Notes:
+ *      Will CRE if threads is 0
+ *      A limit set after the scheduler has started still caps each call,
+ *      but does not stop the workers already made
+ *
+ ************************/
+void SharedScheduler_limit(unsigned threads)
+{
+        assert(threads > 0);
+        threadLimit = threads;
+}
+
+/********** SharedScheduler_bands ********
+ *
+ *  Runs run on bands of 0 to count - 1 on the shared scheduler and the
+ *  calling thread, returning once every band has been run
+ *
+ * Parameters:
+ *      unsigned count: the number of units to split into bands
+ *      void run(unsigned first, unsigned last, void *cl):
+ *                      the function that does units first to last - 1
+ *      void *cl:       the closure passed to run
+ *
+ * Return:
+ *      none
+ *
+ * Expects
+ *      run to not be null
+ *      run to be safe to call from several threads at once
+ *
+ * Notes:
+ *      Will CRE if run is null or memory allocation fails
+ *      Bands are a run of whole units, and no unit is in two bands
+ *      A count of 0 runs nothing, and a count of 1, or any count on a 
+ *      machine with one processor or with a limit of 1, runs on the caller
+ *      alone, without starting the scheduler
+ *
+ ************************/
+void SharedScheduler_bands(unsigned count,
+                           void run(unsigned first, unsigned last, void *cl),
+                           void *cl)
+{
+        assert(run != NULL);
+        if (count == 0) {
+                return;
+        }
+
+        unsigned threads = jobThreads();
+        unsigned bands = BANDS_PER_THREAD * threads;
+        if (bands > count) {
+                bands = count;
+        }
+        if (bands == 1 || threads == 1) {
+                run(0, count, cl);
+                return;
+        }
+
+        Scheduler_T scheduler = SharedScheduler_get();
+        unsigned workers = Scheduler_workers(scheduler);
+        if (workers > threads - 1) {
+                workers = threads - 1;
+        }
+        unsigned helpers = (bands - 1 < workers) ? bands - 1 : workers;
+
+        struct bandJob *job = malloc(sizeof(*job));
+        assert(job != NULL);
+        pthread_mutex_init(&job->lock, NULL);
+        pthread_cond_init(&job->allDone, NULL);
+        job->count = count;
+        job->bands = bands;
+        job->next = 0;
+        job->finished = 0;
+        job->holders = helpers + 1;
+        job->run = run;
+        job->cl = cl;
+
+        for (unsigned i = 0; i < helpers; i++) {
+                Scheduler_submit(scheduler, helpJob, job);
+        }
+        runBands(job);
+
+        pthread_mutex_lock(&job->lock);
+        while (job->finished < job->bands) {
+                pthread_cond_wait(&job->allDone, &job->lock);
+        }
+        pthread_mutex_unlock(&job->lock);
+        letGo(job);
+}
+
+/********** runBands ********
+ *
+ *  Takes bands of a job and runs them until none are left
+ *
+ * Parameters:
+ *      struct bandJob *job: the job
+ *
+ * Return:
+ *      none
+ *
+ ************************/
+static void runBands(struct bandJob *job)
+{
+        pthread_mutex_lock(&job->lock);
+        while (job->next < job->bands) {
+                unsigned band = job->next++;
+                pthread_mutex_unlock(&job->lock);
+
+                /* spread the units as evenly as the bands allow */
+                unsigned first = (unsigned long long)band * job->count /
+                                 job->bands;
+                unsigned last = (unsigned long long)(band + 1) * job->count /
+                                job->bands;
+                job->run(first, last, job->cl);
+
+                pthread_mutex_lock(&job->lock);
+                job->finished++;
+                if (job->finished == job->bands) {
+                        pthread_cond_signal(&job->allDone);
+                }
+        }
+        pthread_mutex_unlock(&job->lock);
+}
+
+/********** helpJob ********
+ *
+ *  A task that runs bands of a job alongside its caller
+ *
+ * Parameters:
+ *      void *vjob: the struct bandJob
+ *
+ * Return:
+ *      none
+ *
+ ************************/
+static void helpJob(void *vjob)
+{
+        struct bandJob *job = vjob;
+        runBands(job);
+        letGo(job);
+}
+
+/********** letGo ********
+ *
+ *  Stops using a job, freeing it if no one else is using it
+ *
+ * Parameters:
+ *      struct bandJob *job: the job
+ *
+ * Return:
+ *      none
+ *
+ ************************/
+static void letGo(struct bandJob *job)
+{
+        pthread_mutex_lock(&job->lock);
+        bool last = (--job->holders == 0);
+        pthread_mutex_unlock(&job->lock);
+
+        if (last) {
+                pthread_mutex_destroy(&job->lock);
+                pthread_cond_destroy(&job->allDone);
+                free(job);
+        }
+}
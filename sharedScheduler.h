@@ -0,0 +1,36 @@
+/*
+ *      sharedScheduler.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the shared Scheduler, one pool
+ *      of worker threads per process, made the first time it is used, with
+ *      a worker for each online processor but one, or fewer if the program
+ *      has limited how many threads it may use. SharedScheduler_bands 
+ *      splits a range of rows (or blocks, or any other units) into bands 
+ *      and runs them on the pool and the calling thread, so a loop whose 
+ *      iterations are independent goes parallel without any threading 
+ *      code of its own.
+ */
+
+#ifndef SHARED_SCHEDULER
+#define SHARED_SCHEDULER
+
+#include "workStealing.h"
+
+Scheduler_T SharedScheduler_get(void);
+
+/* caps the threads, the caller's included, that work on one call to 
+   SharedScheduler_bands; 1 runs every band on the caller. Call it before
+   any other thread uses the shared scheduler */
+void SharedScheduler_limit(unsigned threads);
+
+/* calls run(first, last, cl) on bands that together cover 0 to count - 1,
+   from several threads at once, and returns once every band is done. The
+   calling thread runs bands too, so it may be called from inside a band
+   or from a task on any scheduler. */
+void SharedScheduler_bands(unsigned count,
+                           void run(unsigned first, unsigned last, void *cl),
+                           void *cl);
+
+#endif
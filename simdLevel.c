@@ -0,0 +1,102 @@
+/*
+ *      simdLevel.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation for choosing the level of 
+ *      the vector kernels.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "assert.h"
+
+#include "simdLevel.h"
+
+static const char *NAMES[] = { "scalar", "sse4.1", "avx2", "avx512" };
+
+static enum simdLevel chosen = SIMD_SCALAR;
+static pthread_once_t chooseOnce = PTHREAD_ONCE_INIT;
+
+/********** chooseLevel ********
+ *
+ *  Picks the widest level the CPU supports, capped by COMP40_KERNELS
+ *
+ * Parameters:
+ *      none
+ *
+ * Return:
+ *      none
+ *
+ * Notes:
+ *      Runs once, through pthread_once, so threads may race to ask
+ *      An unknown COMP40_KERNELS is ignored
+ *
+ ************************/
+static void chooseLevel(void)
+{
+        enum simdLevel level = SIMD_SCALAR;
+
+#ifdef SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("sse4.1")) {
+                level = SIMD_SSE41;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+                level = SIMD_AVX2;
+        }
+        if (__builtin_cpu_supports("avx512f")) {
+                level = SIMD_AVX512;
+        }
+#endif
+
+        const char *cap = getenv("COMP40_KERNELS");
+        for (unsigned i = SIMD_SCALAR; cap != NULL && i < level; i++) {
+                if (strcmp(cap, NAMES[i]) == 0) {
+                        level = i;
+                }
+        }
+
+        chosen = level;
+}
+
+/********** SimdLevel_get ********
+ *
+ *  Gives the level of kernels to run, choosing it on the first call
+ *
+ * Parameters:
+ *      none
+ *
+ * Return:
+ *      The widest level both the CPU and COMP40_KERNELS allow
+ *
+ ************************/
+enum simdLevel SimdLevel_get(void)
+{
+        pthread_once(&chooseOnce, chooseLevel);
+        return chosen;
+}
+
+/********** SimdLevel_name ********
+ *
+ *  Names a level the way COMP40_KERNELS does
+ *
+ * Parameters:
+ *      enum simdLevel level: the level to name
+ *
+ * Return:
+ *      "scalar", "sse4.1", "avx2" or "avx512"
+ *
+ * Expects
+ *      level to be one of the simdLevel values
+ *
+ * Notes:
+ *      Will CRE if level is out of range
+ *
+ ************************/
+const char *SimdLevel_name(enum simdLevel level)
+{
+        assert(level <= SIMD_AVX512);
+        return NAMES[level];
+}
@@ -0,0 +1,33 @@
+/*
+ *      simdLevel.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for choosing which vector kernels
+ *      to run: the widest instruction set the CPU supports, found once at
+ *      run time with cpuid. Setting COMP40_KERNELS to scalar, sse4.1, 
+ *      avx2, or avx512 caps the choice, so the kernels can be compared 
+ *      with each other. Kernel files use the SIMD_TARGET macros to compile one 
+ *      function for an instruction set the rest of the program may not 
+ *      assume.
+ */
+
+#ifndef SIMD_LEVEL
+#define SIMD_LEVEL
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_X86 1
+#define SIMD_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+/* narrowest first, so a level also supports every level below it */
+enum simdLevel { SIMD_SCALAR, SIMD_SSE41, SIMD_AVX2, SIMD_AVX512 };
+
+enum simdLevel SimdLevel_get(void);
+
+/* "scalar", "sse4.1", "avx2" or "avx512" */
+const char *SimdLevel_name(enum simdLevel level);
+
+#endif
@@ -0,0 +1,259 @@
+#!/bin/bash
+#
+#       check.sh
+#       by Peter Morganelli and Shepard Rodgers, 10/16/26
+#       arith assignment
+#
+#       Checks a built 40image against known-good outputs. Every image in
+#       images/ (and flowers.ppm and teenyTiny.ppm from the top directory)
+#       is compressed and decompressed in every mode, from a file and from
+#       stdin, and must match expected/ byte for byte, since every mode is
+#       meant to give the same output. The same goes with COMP40_KERNELS
+#       capping the color kernels at each SIMD level, since every kernel
+#       must match the scalar code. The streaming decompressor is fed a few
+#       rows of codewords at a time, and must write their pixels before the
+#       rest arrive. A file whose header names another codeword format must
+#       be refused in every mode. Then the batch codec is run on files that
+#       must fail, to check that each failure is reported for its own file
+#       and that no other file, or existing output, is harmed.
+#
+#       Usage: tests/check.sh [path to 40image]     (default ./40image)
+#
+
+tests=$(cd "$(dirname "$0")" && pwd)
+top=$(dirname "$tests")
+program=${1:-./40image}
+image=$(cd "$(dirname "$program")" && pwd)/$(basename "$program")
+scratch=$(mktemp -d)
+trap 'rm -rf "$scratch"' EXIT
+failures=0
+
+# fail MESSAGE: notes a failed check
+fail()
+{
+        echo "FAIL: $1${COMP40_KERNELS:+ with COMP40_KERNELS=$COMP40_KERNELS}"
+        failures=$((failures + 1))
+}
+
+# inputs: the images with known-good outputs, as NAME=PATH
+inputs()
+{
+        echo "flowers=$top/flowers.ppm"
+        echo "teenyTiny=$top/teenyTiny.ppm"
+        for path in "$tests"/images/*.ppm; do
+                echo "$(basename "$path" .ppm)=$path"
+        done
+}
+
+# roundTrip FLAGS...: compresses and decompresses every input with FLAGS
+roundTrip()
+{
+        for entry in $(inputs); do
+                name=${entry%%=*}
+                path=${entry#*=}
+                expected=$tests/expected/$name
+                "$image" -c "$@" "$path" 2>/dev/null |
+                        cmp -s - "$expected.c40" ||
+                        fail "$name: -c $* differs"
+                "$image" -c "$@" < "$path" 2>/dev/null |
+                        cmp -s - "$expected.c40" ||
+                        fail "$name: -c $* from stdin differs"
+                "$image" -d "$@" "$expected.c40" 2>/dev/null |
+                        cmp -s - "$expected.d.ppm" ||
+                        fail "$name: -d $* differs"
+                "$image" -d "$@" < "$expected.c40" 2>/dev/null |
+                        cmp -s - "$expected.d.ppm" ||
+                        fail "$name: -d $* from stdin differs"
+        done
+}
+
+# several FLAGS...: converts several files in one run, whose outputs must
+# come out one after another, in order
+several()
+{
+        "$image" -c "$@" "$top/flowers.ppm" "$tests/images/odd.ppm" \
+                2>/dev/null |
+                cmp -s - <(cat "$tests/expected/flowers.c40" \
+                               "$tests/expected/odd.c40") ||
+                fail "-c $* with several files differs"
+        "$image" -d "$@" "$tests/expected/flowers.c40" \
+                "$tests/expected/odd.c40" 2>/dev/null |
+                cmp -s - <(cat "$tests/expected/flowers.d.ppm" \
+                               "$tests/expected/odd.d.ppm") ||
+                fail "-d $* with several files differs"
+}
+
+# streamFirstRows: feeds the streaming decompressor the header and a few
+# rows of codewords, then stalls, and checks that the pixels of those rows
+# came out during the stall
+streamFirstRows()
+{
+        local input=$tests/expected/odd.c40
+        local expected=$tests/expected/odd.d.ppm
+        local header rows=3 width height
+        header=$(head -2 "$input" | wc -c)
+        read -r width height < <(sed -n 2p "$input")
+        local given=$((header + rows * (width / 2) * 4))
+        local ppmHeader=$(($(wc -c < "$expected") - width * height * 3))
+        local output=$scratch/stream.ppm
+
+        { head -c $given "$input"; sleep 2
+          tail -c +$((given + 1)) "$input"; } | "$image" -d -s > "$output" &
+        sleep 1
+        local early
+        early=$(wc -c < "$output")
+        wait
+        [ "$early" -ge $((ppmHeader + 2 * rows * width * 3)) ] ||
+                fail "-d -s wrote $early bytes for $rows rows of codewords"
+        cmp -s "$output" "$expected" || fail "-d -s through a pipe differs"
+        if [ -w /dev/full ]; then
+                "$image" -d -s "$input" > /dev/full 2> /dev/null &&
+                        fail "-d -s to a full disk exited 0"
+        fi
+}
+
+# otherFormat: checks that codewords from another format are never decoded
+otherFormat()
+{
+        local other=$scratch/other.c40
+        sed '1s/format [0-9]*$/format 99/' "$tests/expected/odd.c40" > "$other"
+        for mode in "" -f -s -p; do
+                # the braces send the shell's report of the abort to
+                # /dev/null too
+                # shellcheck disable=SC2086
+                { "$image" -d $mode "$other"; } > /dev/null 2>&1 &&
+                        fail "-d $mode decoded another format"
+        done
+        "$image" -d -b "$other" 2> "$scratch/other.err" &&
+                fail "batch decoded another format"
+        grep -qF "other.c40: not a compressed image" "$scratch/other.err" ||
+                fail "batch did not refuse another format"
+        [ ! -e "$scratch/other" ] || fail "another format left an output"
+}
+
+# conflictingFlags: checks that flags which would override or be ignored
+# by the others are refused
+conflictingFlags()
+{
+        local input=$tests/images/odd.ppm
+        for flags in "-f -j 4" "-j 4 -f" "-f -s" "-s -p" "-q 2" "-v" \
+                     "-j 2 -v" "-F" "-f -b"; do
+                # shellcheck disable=SC2086
+                "$image" -c $flags "$input" > /dev/null \
+                        2> "$scratch/flags.err" && fail "-c $flags was accepted"
+                grep -qF "Usage:" "$scratch/flags.err" ||
+                        fail "-c $flags did not print the usage"
+        done
+        "$image" -c -p -j 2 -q 1 -v "$input" > /dev/null 2>&1 ||
+                fail "-c -p -j 2 -q 1 -v was refused"
+}
+
+# expectError FILE MESSAGE: checks that the batch reported MESSAGE for FILE
+expectError()
+{
+        grep -qF "$1: $2" batch.err ||
+                fail "batch did not report '$1: $2'"
+}
+
+# batchFailures: runs batches whose bad files must fail on their own
+batchFailures()
+{
+        local dir=$scratch/batch
+        mkdir "$dir"
+        cd "$dir" || exit 1
+        cp "$tests/expected/flowers.c40" good.c40
+        cp "$tests/expected/odd.c40" photo.ppm.c40
+        cp "$tests/images/odd.ppm" photo.ppm
+        printf 'not an image\n' > junk.c40
+        head -c 100 "$tests/expected/odd.c40" > short.c40
+        printf 'COMP40 Compressed image format 2\n4000000000 4000000000\n' \
+                > huge.c40
+
+        "$image" -d -b good.c40 junk.c40 short.c40 huge.c40 photo.ppm.c40 \
+                missing.c40 2> batch.err
+        [ $? -ne 0 ] || fail "batch with bad files exited 0"
+        cmp -s good "$tests/expected/flowers.d.ppm" ||
+                fail "good file of a failing batch differs"
+        expectError junk.c40 "not a compressed image"
+        expectError short.c40 "truncated image"
+        expectError huge.c40 "image too large"
+        expectError photo.ppm.c40 "output exists"
+        expectError missing.c40 "cannot open input"
+        grep -q "5 of 6 files failed" batch.err ||
+                fail "batch did not count its failures"
+        cmp -s photo.ppm "$tests/images/odd.ppm" ||
+                fail "batch replaced an existing output without -F"
+        for name in junk short huge; do
+                [ ! -e "$name" ] || fail "failed file $name left an output"
+        done
+        ls ./*.part > /dev/null 2>&1 && fail "batch left temporary files"
+
+        # a sample above the maxval must fail its own file, not overflow a
+        # codeword and abort the batch
+        cp "$tests/images/odd.ppm" good.ppm
+        { printf 'P6\n4 2\n10\n'; head -c 24 /dev/zero | tr '\0' '\377'; } \
+                > bright.ppm
+        "$image" -c -b bright.ppm good.ppm 2> batch.err
+        [ $? -eq 1 ] || fail "batch with a bright file did not exit 1"
+        expectError bright.ppm "malformed or truncated image"
+        cmp -s good.ppm.c40 "$tests/expected/odd.c40" ||
+                fail "good file of a batch with a bright file differs"
+        [ ! -e bright.ppm.c40 ] || fail "bright file left an output"
+        ls ./*.part > /dev/null 2>&1 && fail "bright file left temporary files"
+
+        # -F replaces an existing output, but never an output that is
+        # its own input, and a failure leaves the old output alone
+        cp photo.ppm keep.ppm
+        cp photo.ppm keep
+        ln -s photo.ppm link.ppm
+        printf 'photo.ppm photo.ppm\nlink.ppm photo.ppm\n' > same.manifest
+        "$image" -c -F -m same.manifest 2> batch.err
+        expectError photo.ppm "output is the input"
+        expectError link.ppm "output is the input"
+        cmp -s photo.ppm keep.ppm || fail "batch truncated its own input"
+        printf 'short.c40 keep\n' > keep.manifest
+        "$image" -d -F -m keep.manifest 2> batch.err
+        expectError short.c40 "truncated image"
+        cmp -s keep keep.ppm || fail "a failed file harmed its old output"
+        "$image" -d -F -b photo.ppm.c40 2> batch.err ||
+                fail "-F did not replace an existing output"
+        cmp -s photo.ppm "$tests/expected/odd.d.ppm" ||
+                fail "-F output differs"
+
+        # a malformed manifest stops the batch before anything is done
+        printf 'good.c40\n' > bad.manifest
+        "$image" -d -m bad.manifest 2> batch.err &&
+                fail "malformed manifest exited 0"
+        grep -q "bad.manifest:1:" batch.err ||
+                fail "malformed manifest line not reported"
+        cd "$top" || exit 1
+}
+
+for mode in "" -f -s -p "-j 3" "-p -j 2 -q 1"; do
+        # word splitting of $mode is what gives each flag its own argument
+        # shellcheck disable=SC2086
+        roundTrip $mode
+        # shellcheck disable=SC2086
+        several $mode
+done
+
+# a level the CPU lacks falls back to the widest one it has, so every
+# level is tried wherever it can be
+for level in scalar sse4.1 avx2 avx512; do
+        export COMP40_KERNELS=$level
+        for mode in "" -f; do
+                # shellcheck disable=SC2086
+                roundTrip $mode
+        done
+done
+unset COMP40_KERNELS
+streamFirstRows
+otherFormat
+conflictingFlags
+batchFailures
+
+if [ $failures -ne 0 ]; then
+        echo "$failures checks failed"
+        exit 1
+fi
+echo "all checks passed"
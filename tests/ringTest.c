@@ -0,0 +1,172 @@
+/*
+ *      ringTest.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      Checks the Ring abstraction: capacities round up to a power of two,
+ *      a full ring refuses a push and an empty one a pop, items come out in
+ *      the order they went in across many trips around the ring, and one
+ *      producer thread and one consumer thread pass every item between
+ *      them, in order, through a ring small enough to keep filling up.
+ *
+ *      Prints each failed check and exits 1 if there were any.
+ */
+
+/* sched_yield is POSIX, not C99 */
+#define _POSIX_C_SOURCE 200112L
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ringBuffer.h"
+
+/* The items the producer thread sends, and the ring they go through */
+#define THREAD_ITEMS 200000
+#define THREAD_CAPACITY 4
+
+static unsigned failures = 0;
+
+/********** check ********
+ *
+ *  Notes a failed check, printing what was expected
+ *
+ * Parameters:
+ *      int passed:          whether the check passed
+ *      const char *message: what the check expected
+ *
+ * Return:
+ *      none
+ *
+ ************************/
+static void check(int passed, const char *message)
+{
+        if (!passed) {
+                printf("FAIL: %s\n", message);
+                failures++;
+        }
+}
+
+/********** checkCapacities ********
+ *
+ *  Checks that capacities round up to the next power of two
+ *
+ ************************/
+static void checkCapacities(void)
+{
+        unsigned asked[]   = { 1, 2, 3, 4, 5, 100, 1024, 1025 };
+        unsigned rounded[] = { 1, 2, 4, 4, 8, 128, 1024, 2048 };
+        for (unsigned i = 0; i < sizeof(asked) / sizeof(asked[0]); i++) {
+                Ring_T ring = Ring_new(asked[i]);
+                check(Ring_capacity(ring) == rounded[i],
+                      "capacity rounds up to a power of two");
+                check(Ring_depth(ring) == 0, "a new ring is empty");
+                Ring_free(&ring);
+        }
+}
+
+/********** checkFullAndEmpty ********
+ *
+ *  Checks that a ring holds exactly its capacity, refuses a push when
+ *  full and a pop when empty, and keeps its order across many laps
+ *
+ ************************/
+static void checkFullAndEmpty(void)
+{
+        Ring_T ring = Ring_new(8);
+        void *item = NULL;
+        check(!Ring_pop(ring, &item), "an empty ring refuses a pop");
+
+        uintptr_t next = 1, expected = 1;
+        for (unsigned lap = 0; lap < 100; lap++) {
+                for (unsigned i = 0; i < 8; i++) {
+                        check(Ring_push(ring, (void *)next++),
+                              "a ring takes items up to its capacity");
+                }
+                check(Ring_depth(ring) == 8, "a full ring has its capacity");
+                check(!Ring_push(ring, (void *)next),
+                      "a full ring refuses a push");
+
+                /* take out fewer than went in, so later laps start part
+                   way around the ring */
+                for (unsigned i = 0; i < 5; i++) {
+                        check(Ring_pop(ring, &item) &&
+                              (uintptr_t)item == expected++,
+                              "items come out in the order they went in");
+                }
+                while (Ring_pop(ring, &item)) {
+                        check((uintptr_t)item == expected++,
+                              "items come out in the order they went in");
+                }
+                check(Ring_depth(ring) == 0, "an emptied ring is empty");
+        }
+        check(expected == next, "every item pushed is popped");
+        Ring_free(&ring);
+}
+
+/********** produce ********
+ *
+ *  The producer thread: pushes 1 to THREAD_ITEMS, yielding to the
+ *  consumer while the ring is full
+ *
+ ************************/
+static void *produce(void *vring)
+{
+        Ring_T ring = vring;
+        for (uintptr_t item = 1; item <= THREAD_ITEMS; item++) {
+                while (!Ring_push(ring, (void *)item)) {
+                        sched_yield();
+                }
+        }
+        return NULL;
+}
+
+/********** checkThreads ********
+ *
+ *  Checks that every item a producer thread pushes reaches the consumer,
+ *  the calling thread, once and in order
+ *
+ ************************/
+static void checkThreads(void)
+{
+        Ring_T ring = Ring_new(THREAD_CAPACITY);
+        pthread_t producer;
+        int failed = pthread_create(&producer, NULL, produce, ring);
+        check(failed == 0, "the producer thread starts");
+        if (failed != 0) {
+                Ring_free(&ring);
+                return;
+        }
+
+        unsigned outOfOrder = 0;
+        for (uintptr_t expected = 1; expected <= THREAD_ITEMS; expected++) {
+                void *item = NULL;
+                while (!Ring_pop(ring, &item)) {
+                        sched_yield();
+                }
+                if ((uintptr_t)item != expected) {
+                        outOfOrder++;
+                }
+        }
+        pthread_join(producer, NULL);
+
+        check(outOfOrder == 0, "a consumer thread gets every item in order");
+        check(Ring_depth(ring) == 0, "nothing is left after the consumer");
+        Ring_free(&ring);
+}
+
+int main(void)
+{
+        checkCapacities();
+        checkFullAndEmpty();
+        checkThreads();
+
+        if (failures != 0) {
+                printf("%u ring checks failed\n", failures);
+                return EXIT_FAILURE;
+        }
+        printf("all ring checks passed\n");
+        return EXIT_SUCCESS;
+}
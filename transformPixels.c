@@ -14,36 +14,37 @@
 
 #include "componentVideo.h"
 #include "uarray2.h"
+#include "cvPlanes.h"
+#include "colorKernels.h"
+#include "codecArena.h"
+#include "a2methodsExt.h"
+#include "sharedScheduler.h"
 #include "transformPixels.h"
 #include "pnm.h"
 
+/* the rgbRows struct is passed to convertRgbRows as its closure */
+struct rgbRows {
+        PpmImage_T image;
+        CvPlanes_T planes;
+};
+
+/* the cvRows struct is passed to convertCvRows as its closure */
+struct cvRows {
+        CvPlanes_T planes;
+        A2MethodsExt_T ext;
+        A2Methods_UArray2 uarray2;
+        unsigned denominator;
+};
+
 /* Compression Functions */
-void populateCv(int col, int row, A2Methods_UArray2 uarray2, void *elem, 
-                void *cl);
-void calculateCv(void *elem, void *pixel, unsigned denominator);
+void convertRgbRows(unsigned first, unsigned last, void *cl);
+void calculateCv(void *beforePix, void *afterPix, unsigned denominator);
 
 /* Decompression Functions */
-void populateRgb(int col, int row, A2Methods_UArray2 uarray2, void *elem, 
-                 void *cl);
+void convertCvRows(unsigned first, unsigned last, void *cl);
 void calculateRgb(void *beforePix, void *afterPix, unsigned denominator);
 float capOrNoCapRGB(float coefficient);
 
-/* Compression and Decompression Functions */
-void applyTransform(int i, int j, A2Methods_UArray2 array2b, void *elem, 
-                    void *cl);
-
-/* the transformClosure struct can be passed to the applyTransform function
-   when mapping to provide useful information for RGB<-->CV conversions */
-struct transformClosure {
-        A2Methods_UArray2 newUArray2; /* a 2d array to put values in */
-        A2Methods_T methods; /* methods for getting values from the 2d array */
-        unsigned denominator; /* the denominator used for scaling pixels */
-        void (*calculate)(void *beforePix, void *afterPix, 
-                          unsigned denominator);
-                /* ^ pointer to the function being used for transformation math
-                (depends on whether we are compressing or decompressing) */
-};
-
 /****************************************************************
 *                                                               *
 *                    Compression Functions                      *
@@ -55,90 +56,77 @@ struct transformClosure {
  *  To transform all the RGB pixels into a component-video representation
  *
  * Parameters:
- *      A2Methods_UArray2 uarray2: the uarray2 of RGB values
- *      A2Methods_T methods:       the methods that uarray2 uses
- *      unsigned denominator:      the denominator of the original to scale 
+ *      PpmImage_T image:    the image of RGB samples, already cropped to 
+ *                           an even width and height
+ *      CodecArena_T arena:  the arena holding the planes
  *
  * Return: 
- *      An A2Methods_UArray2 containing componentVideo stucts
+ *      CvPlanes_T holding the Y, Pb and Pr planes of the image, which
+ *      belong to the arena
  *
  * Expects
- *      uarray to not be null
- *      methods to not be null
+ *      image and arena to not be null
  * 
  * Notes:
- *      Will CRE if uarray2 is null
- *      Will CRE is methods are null
- *      Allocates and frees a transformClosure struct
+ *      Will CRE if image or arena is null
+ *      Will CRE if memory allocation for the planes or a row fails
+ *      Bands of rows are converted at once on the shared scheduler
  *      
  ************************/
-A2Methods_UArray2 rgbToCv(A2Methods_UArray2 uarray2, A2Methods_T methods, 
-                          unsigned denominator)
+CvPlanes_T rgbToCv(PpmImage_T image, CodecArena_T arena)
 {
-        assert(uarray2 != NULL);
-        assert(methods != NULL);
+        assert(image != NULL);
+        assert(arena != NULL);
 
-        /* create a new array to store component video values */
-        A2Methods_UArray2 newUArray2 = methods->new(methods->width(uarray2), 
-                                                    methods->height(uarray2), 
-                                                sizeof(struct componentVideo));
-        
-        /* create a transformation struct to store info needed to transform 
-           and pass it as closure to mapping func */
-        struct transformClosure *transformation = malloc(sizeof
-                                                         (*transformation));
-        assert(transformation != NULL);
-        transformation->newUArray2 = newUArray2;
-        transformation->methods = methods;
-        transformation->denominator = denominator;
-        transformation->calculate = calculateCv; /* choose func to calculate cv
-                                                    values from rgb */
-
-        /* populate new uarray2 with component video structs, then fill it with
-        cv values from rgb conversion */
-        methods->map_default(newUArray2, populateCv, methods);
-        methods->map_default(uarray2, applyTransform, transformation);
-
-        free(transformation);
-        return newUArray2;
+        CvPlanes_T planes = CodecArena_planes(arena, image->width, 
+                                              image->height);
+
+        struct rgbRows rows = { image, planes };
+        SharedScheduler_bands(image->height, convertRgbRows, &rows);
+
+        return planes;
 }
 
-/********** populateAverages ********
+/********** convertRgbRows ********
  *
- * Description: apply function to populate the given uarray2 with 
- *              componentVideo structs
+ *  To convert a band of rows of an image into the planes
  *
- * Input Parameters:
- *      int col:                   (UNUSED) The current col in uarray2 
- *      int row:                   (UNUSED) The current row in uarray2
- *      A2Methods_UArray2 uarray2: (UNUSED) The uarray2 on which the function 
- *                                          is applied
- *      void *elem:                The elem at (col, row) in uarray2
- *      void *cl:                  (UNUSED) The closure variable for this apply
+ * Parameters:
+ *      unsigned first: the first row of the band
+ *      unsigned last:  the row after the band
+ *      void *cl:       the struct rgbRows
  *
- * Ouput:
- *      None
+ * Return: 
+ *      none
  *
+ * Expects
+ *      cl to not be null
+ * 
  * Notes:
- *      will CRE if elem is NULL
- *      will CRE if the allocated componentVideo struct is NULL (freed here)
+ *      Will CRE if cl is null or memory allocation for a row fails
+ *      Each row is expanded to RGB pixels and converted by the color 
+ *      kernels, which write each row of each plane front to back
  *      
  ************************/
-void populateCv(int col, int row, A2Methods_UArray2 uarray2, void *elem, 
-                void *cl)
+void convertRgbRows(unsigned first, unsigned last, void *cl)
 {
-        (void) col;
-        (void) row;
-        (void) uarray2;
-        (void) cl;
-        assert(elem != NULL);
-
-        /* create and store component video struct */
-        struct componentVideo *pixel = calloc(1, sizeof(*pixel));
-        assert(pixel != NULL);
-
-        *(struct componentVideo *)elem = *pixel;
-        free(pixel);
+        assert(cl != NULL);
+        struct rgbRows *rows = cl;
+        PpmImage_T image = rows->image;
+        CvPlanes_T planes = rows->planes;
+
+        Pnm_rgb pixels = malloc((image->width + 1) * sizeof(*pixels));
+        assert(pixels != NULL);
+
+        for (unsigned row = first; row < last; row++) {
+                size_t start = CvPlanes_index(planes, 0, row);
+                PpmImage_row(image, row, pixels);
+                ColorKernels_rgbToCv(pixels, image->width, 
+                                     image->denominator, planes->Y + start,
+                                     planes->Pb + start, planes->Pr + start);
+        }
+
+        free(pixels);
 }
 
 /********** calculateCv ********
@@ -190,98 +178,88 @@ void calculateCv(void *beforePix, void *afterPix, unsigned denominator)
 
 /********** cvToRgb ********
 *
-*  To transform all the cv struct into an RGB representation
+*  To transform the component video planes into an RGB representation
 *
 * Parameters:
-*      A2Methods_UArray2 uarray2: the uarray2 of CV structs values
-*      A2Methods_T methods:       the methods that uarray2 uses
+*      CvPlanes_T planes:         the Y, Pb and Pr planes of the image
+*      A2Methods_T methods:       the methods that the new uarray2 should use
 *      unsigned denominator:      the denominator of the original to scale 
 *
 * Return: 
 *      An A2Methods_UArray2 containing RGB values
 *
 * Expects
-*      uarray to not be null
+*      planes to not be null
 *      methods to not be null
 * 
 * Notes:
-*      Will CRE if uarray2 is null
+*      Will CRE if planes is null
 *      Will CRE is methods are null
-*      Allocates and frees a transformClosure struct
-*      May CRE if memory allocation for transformClosure struct fails
+*      Will CRE if methods is not the plain or blocked suite
+*      The color kernels write each span of a row straight into the array,
+*      so every pixel of the array is written without being cleared first
+*      Bands of rows are converted at once on the shared scheduler
 *      
 ************************/
-A2Methods_UArray2 cvToRgb(A2Methods_UArray2 uarray2, A2Methods_T methods, 
+A2Methods_UArray2 cvToRgb(CvPlanes_T planes, A2Methods_T methods, 
                           unsigned denominator)
 {
-        assert(uarray2 != NULL);
+        assert(planes != NULL);
         assert(methods != NULL);
         
         /* create a new array to store rgb values */
-        A2Methods_UArray2 newUArray2 = methods->new(methods->width(uarray2), 
-                                                    methods->height(uarray2), 
+        A2Methods_UArray2 newUArray2 = methods->new(planes->width, 
+                                                    planes->height, 
                                                     sizeof(struct Pnm_rgb));
 
-        /* create a transformation struct to store info needed to transform 
-           and pass it as closure to mapping func */
-        struct transformClosure *transformation = malloc(sizeof
-                                                        (*transformation));
-        assert(transformation != NULL);
+        A2MethodsExt_T ext = A2Methods_ext(methods);
+        assert(ext != NULL);
 
-        transformation->newUArray2 = newUArray2;
-        transformation->methods = methods;
-        transformation->denominator = denominator;
-        transformation->calculate = calculateRgb;/*choose func to calculate rgb
-                                                    values from cv */
-
-        /* populate new uarray2 with rgb structs, then fill it with 
-           rgb values from cv conversion */
-        methods->map_default(newUArray2, populateRgb, methods);
-        methods->map_default(uarray2, applyTransform, transformation);
-
-        free(transformation);
-        methods->free(&uarray2);
+        struct cvRows rows = { planes, ext, newUArray2, denominator };
+        SharedScheduler_bands(planes->height, convertCvRows, &rows);
 
         return newUArray2;
 }
 
-/********** populateRgb ********
- *
- *  To transform all the RGB pixels into a component-video representation
- *
- * Parameters:
- *      A2Methods_UArray2 uarray2: the uarray2 of RGB values
- *      A2Methods_T methods:       the methods that uarray2 uses
- *      unsigned denominator:      the denominator of the original to scale 
- *
- * Return: 
- *      An A2Methods_UArray2 containing componentVideo stucts
- *
- * Expects
- *      uarray to not be null
- *      methods to not be null
- * 
- * Notes:
- *      Will CRE if uarray2 is null
- *      Will CRE is methods are null
- *      Allocates and frees a transformClosure struct
- *      
- ************************/
-void populateRgb(int col, int row, A2Methods_UArray2 uarray2, void *elem, 
-                 void *cl)
+/********** convertCvRows ********
+*
+*  To convert a band of rows of the planes straight into the RGB uarray2
+*
+* Parameters:
+*      unsigned first: the first row of the band
+*      unsigned last:  the row after the band
+*      void *cl:       the struct cvRows
+*
+* Return: 
+*      none
+*
+* Expects
+*      cl to not be null
+* 
+* Notes:
+*      Will CRE if cl is null
+*      Each row is converted a span of contiguous pixels at a time
+*      
+************************/
+void convertCvRows(unsigned first, unsigned last, void *cl)
 {
-        (void) col;
-        (void) row;
-        (void) uarray2;
-        (void) cl;
-        assert(elem != NULL);
-
-        /* create and store rgb struct  */
-        Pnm_rgb pixel = calloc(1, sizeof(*pixel));
-        assert(pixel != NULL);
-        
-        *(Pnm_rgb)elem = *pixel;
-        free(pixel);
+        assert(cl != NULL);
+        struct cvRows *rows = cl;
+        CvPlanes_T planes = rows->planes;
+
+        int length;
+        for (unsigned row = first; row < last; row++) {
+                size_t start = CvPlanes_index(planes, 0, row);
+                for (unsigned col = 0; col < planes->width; col += length) {
+                        Pnm_rgb pixels = rows->ext->span(rows->uarray2, col,
+                                                         row, &length);
+                        ColorKernels_cvToRgb(planes->Y + start + col, 
+                                             planes->Pb + start + col,
+                                             planes->Pr + start + col, 
+                                             length, rows->denominator, 
+                                             pixels);
+                }
+        }
 }
 
 /********** calculateRgb ********
@@ -361,49 +339,3 @@ float capOrNoCapRGB(float coefficient)
         }
         return coefficient;
 }
-
-/****************************************************************
-*                                                               *
-*           Compression and Decompression Functions             *
-*                                                               *
-*****************************************************************/
-
-
-/********** applyTransform ********
- *
- *  An apply function to be called to transform CV elements to RGB
- *
- * Parameters:
- *      int col:                   the current col apply is being called on
- *      int row:                   the current row apply is being called on
- *      A2Methods_UArray2 uarray2: the uarray2 apply is being called on
- *      void *elem:                a pointer to the current element in uarray2
- *      voic *cl:                  a closure variable holding transformClosure
- *
- * Return: 
- *      none
- *
- * Expects
- *      none
- * 
- * Notes:
- *      none
- *      
- ************************/
-void applyTransform(int col, int row, A2Methods_UArray2 uarray2, void *elem, 
-                    void *cl)
-{       
-        (void) uarray2;
-        assert(elem != NULL);
-        assert(cl != NULL);
-
-        /* Use closure struct to get the array in which to store 
-           transformed values in */
-        struct transformClosure *closureStruct = cl;
-        void *pixel = closureStruct->methods->at(closureStruct->newUArray2, 
-                                                 col, row);
-
-        /* Call the correct calculate function, given in the closure, to 
-           do the actual transformation */
-        closureStruct->calculate(elem, pixel, closureStruct->denominator);
-}
@@ -5,9 +5,9 @@
  *
  *      This file contains the interface for transformPixels, which provides
  *      functions to convert rgb pixel values to component video pixel values 
- *      and vice versa. It also gives functions to populate a 2d array with
- *      both rgb and component video structs, but to use these structs one
- *      must include pnm.h or componentVideo.h, respectively.
+ *      and vice versa. Component video is held in CvPlanes, one plane each
+ *      for Y, Pb and Pr, whose storage and row buffers come from a 
+ *      CodecArena. To use the rgb structs one must include pnm.h.
  */
 
 #ifndef TRANSFORM_PIXELS
@@ -15,18 +15,18 @@
 
 #include "a2blocked.h"
 #include "a2plain.h"
+#include "ppmImage.h"
+#include "cvPlanes.h"
+#include "codecArena.h"
 
 /* Compression */
-A2Methods_UArray2 rgbToCv(A2Methods_UArray2 uarray2, A2Methods_T methods, 
-                          unsigned denominator);
-void populateCv(int col, int row, A2Methods_UArray2 uarray2, void *elem, 
-                void *cl);
+CvPlanes_T rgbToCv(PpmImage_T image, CodecArena_T arena);
+void calculateCv(void *beforePix, void *afterPix, unsigned denominator);
 
 /* Decompression */
-A2Methods_UArray2 cvToRgb(A2Methods_UArray2 uarray2, A2Methods_T methods, 
+A2Methods_UArray2 cvToRgb(CvPlanes_T planes, A2Methods_T methods, 
                           unsigned denominator);
-void populateRgb(int col, int row, A2Methods_UArray2 uarray2, void *elem, 
-                 void *cl);
+void calculateRgb(void *beforePix, void *afterPix, unsigned denominator);
 
 #undef TRANSFORM_PIXELS
 #endif
\ No newline at end of file
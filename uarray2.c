@@ -185,6 +185,36 @@ void *UArray2_at(UArray2_T uarray2, int col, int row)
         return UArray_at(uarray2->elements, index);
 }
 
+/********** UArray2_row ********
+ *
+ * Description: To return a pointer to the first element of the given row,
+ *              so that the whole row can be used as a plain C array
+ *
+ * Input Parameters:
+ *      T uarray2 = the UArray2 data structure
+ *      int row = the index of the given row
+ *
+ * Ouput:
+ *      a void pointer to the element in column 0 of the given row
+ *
+ * Notes:
+ *      Expects row to be less than the height and the width to be positive
+ *      It is a checked runtime error for uarray2 to be null
+ *      The elements of a row are contiguous, and each row starts 
+ *      UArray2_width * UArray2_size bytes after the one above it, so the
+ *      bounds are checked once per row rather than once per element
+ *      
+ ************************/
+void *UArray2_row(UArray2_T uarray2, int row)
+{
+        /* ensure input is valid */
+        assert(uarray2 != NULL);
+        assert(uarray2->width > 0);
+        assert(row >= 0 && row < uarray2->height);
+
+        return UArray_at(uarray2->elements, uarray2->width * row);
+}
+
 /********** UArray2_map_row_major ********
  *
  * Description: To call the apply function for each element in the array.
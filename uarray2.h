@@ -25,6 +25,10 @@ int UArray2_size(UArray2_T uarray2);
 
 void *UArray2_at(UArray2_T uarray2, int col, int row);
 
+/* The cells of a row are contiguous, and rows are width * size bytes 
+   apart */
+void *UArray2_row(UArray2_T uarray2, int row);
+
 void UArray2_map_row_major
         (UArray2_T uarray2, 
         void apply(int col, int row, UArray2_T uarray2, void *p1, void *p2), 
@@ -1,77 +1,86 @@
+/* posix_memalign is POSIX, not C99 */
+#define _POSIX_C_SOURCE 200112L
+
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "assert.h"
 #include "mem.h"
-#include "uarray.h"
-#include "uarray2.h"
 #include "uarray2b.h"
 
 #define T UArray2b_T
 
+/* every array's cells start on, and fill a multiple of, this many bytes */
+#define CELL_ALIGNMENT 64
+
+/* the cache size assumed when the system does not report one */
+#define DEFAULT_CACHE_BYTES (32 * 1024)
+
 struct T { /* represents a 2D array of cells each of size 'size' */
         int width, height;
         unsigned blocksize;
         unsigned size;
-        UArray2_T blocks;
+        int xblocks, yblocks;   /* width and height in blocks */
+        int shift;              /* log2 of blocksize, or -1 if it is not */
+                                /* a power of two                        */
+        char *cells;
         /*
-         * matrix of blocks, each blocksize * blocksize 
+         * one allocation of xblocks * yblocks blocks, each blocksize *
+         * blocksize cells of size 'size'
          *
-         * matrix dimensions are width and height divided by blocksize,
+         * xblocks and yblocks are width and height divided by blocksize,
          * rounded up
          *
-         * a block is a Uarray_T of length blocksize * blocksize 
-         * and size 'size'
+         * blocks are stored block row by block row: block (bx, by)
+         * starts at cell (by * xblocks + bx) * blocksize * blocksize
          *
-         * invariant relating cells in blocks to cells in the abstraction
-         *  described in section on coordinate transformations below
+         * within a block, cells are stored row by row: cell (i, j) is at
+         * (j % blocksize) * blocksize + i % blocksize of its block, so
+         * UArray2b_map visits the cells in the order they are stored
          */
 };
 
-#include <stdio.h>  /* include so we can print diagnostics */
+/* returns log2 of n if n is a power of two, and -1 if it is not */
+static int log2Exact(unsigned n)
+{
+        int shift = 0;
+        while ((1u << shift) < n) {
+                shift++;
+        }
+        return (1u << shift) == n ? shift : -1;
+}
 
 T UArray2b_new(int width, int height, int size, int blocksize)
 {
         assert(blocksize > 0);
+        assert(width >= 0 && height >= 0 && size > 0);
         T array;
         NEW(array);
         array->width  = width;
         array->height = height;
         array->size   = size;
         array->blocksize = blocksize;
-        array->blocks = UArray2_new((width  + blocksize - 1) / blocksize,
-                                    (height + blocksize - 1) / blocksize,
-                                    sizeof(UArray_T));
-        int xblocks = UArray2_width (array->blocks); 
-        int yblocks = UArray2_height(array->blocks);
-        for (int i = 0; i < xblocks; i++) {
-                for (int j = 0; j < yblocks; j++) {
-                        UArray_T *block = UArray2_at(array->blocks, i, j);
-                        *block = UArray_new(blocksize * blocksize, size);
-                        
-                        if (0) {
-                                fprintf(stderr, "Allocated %p; put %p at %p\n",
-           (void *)*block, (void *)*(UArray_T*)UArray2_at(array->blocks, i, j),
-                                        UArray2_at(array->blocks, i, j));
-                        }
-                }
-        }
+        array->shift  = log2Exact(blocksize);
+        array->xblocks = (width  + blocksize - 1) / blocksize;
+        array->yblocks = (height + blocksize - 1) / blocksize;
+
+        size_t bytes = (size_t)array->xblocks * array->yblocks *
+                       blocksize * blocksize * size;
+        bytes += CELL_ALIGNMENT - bytes % CELL_ALIGNMENT;
+        void *cells = NULL;
+        int failed = posix_memalign(&cells, CELL_ALIGNMENT, bytes);
+        assert(failed == 0);
+        /* every cell starts zeroed, as UArray_new and UArray2_new do */
+        memset(cells, 0, bytes);
+        array->cells = cells;
         return array;
 }
 
 void UArray2b_free(T *array2b)
 {
-        int i;
         assert(array2b && *array2b);
-        T array = *array2b;
-        int xblocks = UArray2_width (array->blocks);
-        int yblocks = UArray2_height(array->blocks);
-        assert(UArray2_size(array->blocks) == sizeof(UArray_T));
-        for (i = 0; i < xblocks; i++) {
-                for (int j = 0; j < yblocks; j++) {
-                        UArray_T *p = UArray2_at(array->blocks, i, j);
-                        UArray_free(p);
-                }
-        }
-        UArray2_free(&(*array2b)->blocks);
+        free((*array2b)->cells);
         FREE(*array2b);
 }
 
@@ -85,59 +94,132 @@ T UArray2b_new_64K_block(int width, int height, int size)
         /*  assert as big as possible */
         assert((blocksize + 1) * (blocksize + 1) * size > 64 * 1024);
         if (size <= 64 * 1024) { /* but no bigger */
-                assert(blocksize * blocksize * size <= 64 * 1024); 
+                assert(blocksize * blocksize * size <= 64 * 1024);
+        }
+        return UArray2b_new(width, height, size, blocksize);
+}
+
+T UArray2b_new_cache_block(int width, int height, int size)
+{
+        assert(size > 0);
+        long cache = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+        if (cache <= 0) {
+                cache = DEFAULT_CACHE_BYTES;
+        }
+        /* the largest power of two whose block fits in the cache... */
+        int blocksize = 1;
+        while ((long)(2 * blocksize) * (2 * blocksize) * size <= cache) {
+                blocksize *= 2;
+        }
+        /* ...but no larger than the array needs */
+        int longest = width > height ? width : height;
+        while (blocksize > 1 && blocksize / 2 >= longest) {
+                blocksize /= 2;
         }
         return UArray2b_new(width, height, size, blocksize);
 }
 
+/* returns the first cell of block (bx, by) */
+static inline char *blockAt(T array2b, int bx, int by)
+{
+        size_t cells = (size_t)array2b->blocksize * array2b->blocksize;
+        return array2b->cells + ((size_t)by * array2b->xblocks + bx) *
+                                cells * array2b->size;
+}
+
 void *UArray2b_at(T array2b, int i, int j)
 {
         assert(array2b != NULL);
         assert(i >= 0 && j >= 0);
         /* avoid unused cells */
         assert(i < array2b->width && j < array2b->height);
-        int b  = array2b->blocksize;
-        int bx = i / b;   /* block x coordinate */
-        int by = j / b;   /* block y coordinate */
-        UArray_T *blockp = UArray2_at(array2b->blocks, bx, by);
-        return UArray_at(*blockp, (i % b) * b + j % b);
+        int    s = array2b->shift;
+        size_t block, cell;
+        if (s >= 0) {
+                int mask = (1 << s) - 1;
+                block = ((size_t)(j >> s) * array2b->xblocks + (i >> s))
+                        << (2 * s);
+                cell  = ((j & mask) << s) + (i & mask);
+        } else {
+                int b = array2b->blocksize;
+                block = ((size_t)(j / b) * array2b->xblocks + i / b) * b * b;
+                cell  = (j % b) * b + i % b;
+        }
+        return array2b->cells + (block + cell) * array2b->size;
+}
+
+void *UArray2b_span(T array2b, int i, int j, int *length)
+{
+        assert(length != NULL);
+        void *cell = UArray2b_at(array2b, i, j);
+        int   b    = array2b->blocksize;
+        int   left = b - i % b;  /* cells from i to the end of its block */
+        *length = array2b->width - i < left ? array2b->width - i : left;
+        return cell;
+}
+
+/* visits the cells of block (bx, by) in the order they are stored */
+static void mapBlock(T array2b, int bx, int by,
+                     void apply(int col, int row, T array2b,
+                                void *elem, void *cl),
+                     void *cl)
+{
+        int   h    = array2b->height;
+        int   w    = array2b->width;
+        int   b    = array2b->blocksize;
+        int   size = array2b->size;
+        char *line = blockAt(array2b, bx, by);
+        /* (i0, j0) correspond to upper left */
+        /* corner of block (bx, by)          */
+        int i0 = b * bx;
+        int j0 = b * by;
+        /* unused cells are only at the ends of the */
+        /* last blocks, so skip them by the bounds  */
+        int iend = w - i0 < b ? w - i0 : b;
+        int jend = h - j0 < b ? h - j0 : b;
+        for (int j = 0; j < jend; j++) {
+                char *elem = line;
+                for (int i = 0; i < iend; i++) {
+                        apply(i0 + i, j0 + j, array2b, elem, cl);
+                        elem += size;
+                }
+                line += b * size;
+        }
 }
 
-void UArray2b_map(T array2b, 
+void UArray2b_map(T array2b,
                   void apply(int col, int row, T array2b,
                              void *elem, void *cl),
                   void *cl)
 {
         assert(array2b != NULL);
-        int       h      = array2b->height;
-        int       w      = array2b->width;
-        int       b      = array2b->blocksize;
-        UArray2_T blocks = array2b->blocks;
-        int       bw     = UArray2_width(blocks);
-        int       bh     = UArray2_height(blocks);
-
-        for (int bx = 0; bx < bw; bx++) {
-                for (int by = 0; by < bh; by++) {
-                        UArray_T *blockp = UArray2_at(blocks, bx, by);
-                        UArray_T  block  = *blockp;
-                        int       len    = UArray_length(block);
-                        /* (i0, j0) correspond to upper left */
-                        /* corner of block (bx, by)          */
-                        int i0 = b * bx; 
-                        int j0 = b * by; 
-                        for (int cell = 0; cell < len; cell++) {
-                                int i = i0 + cell / b;
-                                int j = j0 + cell % b;
-                                /* measured overhead 0.5% to 1.5% */
-                                if (i < w && j < h) {
-                                        apply(i, j, array2b, 
-                                              UArray_at(block, cell), cl);
-                                }
-                        }
+        for (int by = 0; by < array2b->yblocks; by++) {
+                for (int bx = 0; bx < array2b->xblocks; bx++) {
+                        mapBlock(array2b, bx, by, apply, cl);
                 }
         }
 }
 
+int UArray2b_blockcount(T array2b)
+{
+        assert(array2b != NULL);
+        return array2b->xblocks * array2b->yblocks;
+}
+
+void UArray2b_map_range(T array2b, int first, int last,
+                        void apply(int col, int row, T array2b,
+                                   void *elem, void *cl),
+                        void *cl)
+{
+        assert(array2b != NULL);
+        assert(0 <= first && first <= last);
+        assert(last <= array2b->xblocks * array2b->yblocks);
+        for (int block = first; block < last; block++) {
+                mapBlock(array2b, block % array2b->xblocks,
+                         block / array2b->xblocks, apply, cl);
+        }
+}
+
 int UArray2b_height(T array2b)
 {
         assert(array2b != NULL);
@@ -160,5 +242,3 @@ int UArray2b_blocksize(T array2b)
         assert(array2b != NULL);
         return array2b->blocksize;
 }
-
-int UArray2b_version_uses_UArray2_T = 1;
\ No newline at end of file
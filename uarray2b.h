@@ -5,7 +5,7 @@
 typedef struct T *T;
 
 /* 
- * new blocked 2d array
+ * new blocked 2d array, with every cell zeroed
  * blocksize = square root of # of cells in block. 
  * blocksize < 1 is a checked runtime error
  */
@@ -16,6 +16,11 @@ extern T    UArray2b_new (int width, int height, int size, int blocksize);
  */
 extern T    UArray2b_new_64K_block(int width, int height, int size);
 
+/* new blocked 2d array: blocksize the largest power of two provided
+ * block fits in the level 1 data cache, and no larger than the array
+ */
+extern T    UArray2b_new_cache_block(int width, int height, int size);
+
 extern void  UArray2b_free     (T *array2b);
 
 extern int   UArray2b_width    (T  array2b);
@@ -28,12 +33,30 @@ extern int   UArray2b_blocksize(T  array2b);
  */
 extern void *UArray2b_at(T array2b, int column, int row);
 
+/* return a pointer to the cell in the given column and row, and set
+ * *length to the number of cells from it rightward that are contiguous
+ * (to the end of its block or of the row, whichever comes first).
+ * index out of range is a checked run-time error
+ */
+extern void *UArray2b_span(T array2b, int column, int row, int *length);
+
 /* visits every cell in one block before moving to another block */
 extern void  UArray2b_map(T array2b, 
                           void apply(int col, int row, T array2b,
                                      void *elem, void *cl), 
                           void *cl);
 
+/* the number of blocks, which are numbered row by row from 0 */
+extern int   UArray2b_blockcount(T array2b);
+
+/* visits every cell in blocks first to last - 1, one block at a time;
+ * calls for disjoint ranges touch disjoint cells, so they may run at once
+ */
+extern void  UArray2b_map_range(T array2b, int first, int last,
+                                void apply(int col, int row, T array2b,
+                                           void *elem, void *cl),
+                                void *cl);
+
 /* 
  * it is a checked run-time error to pass a NULL T
  * to any function in this interface 
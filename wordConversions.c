@@ -18,11 +18,15 @@
 #include "wordConversions.h"
 #include "a2blocked.h"
 #include "a2plain.h"
-#include "componentVideo.h"
 #include "arith40.h"
 #include "transformPixels.h"
+#include "cvPlanes.h"
+#include "blockKernels.h"
+#include "wordKernels.h"
 #include "math.h"
 #include "packOrUnpack.h"
+#include "a2methodsExt.h"
+#include "sharedScheduler.h"
 
 /* A constant integer representing the blocksize for a 2x2 block */
 const int BLOCKSIZE = 2;
@@ -44,35 +48,27 @@ struct blockAverages {
         uint64_t pr; /*average color-difference proportional to R - Y*/
 };
 
-/* struct to be passed as closure to a conversion mapping function, containing
-   the 2d array in which the end product of conversion (either words or
-   component video pixels) will be stored and corresponding methods) */
-struct averagesClosure {
-        A2Methods_UArray2 closureUArray2;/* uarray2 to store converted values*/
-        A2Methods_T methods; /* methods for the uarray2 */
+/* the wordRows struct is passed to packWordRows and unpackWordRows as
+   their closure */
+struct wordRows {
+        CvPlanes_T planes;
+        A2Methods_T methods;
+        A2Methods_UArray2 words;
 };
 
 /* Compression Functions */
-void calculateAndPackWords(int col, int row, A2Methods_UArray2 uarray2, 
-                           void *elem, void *cl);
-void findAverageChroma(struct componentVideo *cell1, 
-                       struct componentVideo *cell2, 
-                       struct componentVideo *cell3, 
-                       struct componentVideo *cell4, 
-                       struct blockAverages *averagesStruct);
+void packWordRows(unsigned first, unsigned last, void *cl);
+float averageOfFour(float value1, float value2, float value3, float value4);
 void discreteCosineTransform(float Y1, float Y2, float Y3, float Y4, 
                              struct blockAverages *averagesStruct);
 float capOrNoCapDCT(float coefficient);
 
 /* Decompression Functions */
-void unpackAndCalculateCv(int col, int row, A2Methods_UArray2 uarray2, 
-                          void *elem, void *cl);
-void unpackAverages(struct blockAverages *averagesStruct, uint32_t arrayWord);
+void unpackWordRows(unsigned first, unsigned last, void *cl);
 void convertAverages(struct blockAverages *averagesStruct, 
                      struct cvBlock *cvBlockStruct); 
-void setCv(struct cvBlock *cvBlockStruct, 
-           struct componentVideo *cvStruct1, struct componentVideo *cvStruct2, 
-           struct componentVideo *cvStruct3, struct componentVideo *cvStruct4);
+void setPlanes(struct cvBlock *cvBlockStruct, CvPlanes_T planes, 
+               unsigned col, unsigned row);
 
 /****************************************************************
 *                                                               *
@@ -82,177 +78,229 @@ void setCv(struct cvBlock *cvBlockStruct,
 
 /********** blocksToWords ********
  *
- * Description: Transforms a uarray2 of component video pixels to 32-bit words
+ * Description: Transforms component video planes to 32-bit words
  *
  * Input Parameters:
- *      A2Methods_UArray2 uarray2: the uarray2 of pixels
- *      A2Methods_T methods: the type of methods that uarray2 uses
+ *      CvPlanes_T planes: the Y, Pb and Pr planes of the image
+ *      A2Methods_T methods: the methods that the new uarray2 should use
  *
  * Ouput:
  *      A new uarray2 which contains 32-bit words
  * 
  * Expects:
- *      uarray2 to not be null
+ *      planes to not be null
  *      methods to not be null
  * Notes:
- *      Expects uarray2 and methods to not be NULL, otherwise will CRE
+ *      Expects planes and methods to not be NULL, otherwise will CRE
  *      May CRE if memory allocation fails
- *      Frees memory allocated for uarray2
+ *      Packs bands of rows of codewords at once on the shared scheduler
  *      
  ************************/
-A2Methods_UArray2 blocksToWords(A2Methods_UArray2 uarray2, A2Methods_T methods)
+A2Methods_UArray2 blocksToWords(CvPlanes_T planes, A2Methods_T methods)
 {
-        assert(uarray2 != NULL);
+        assert(planes != NULL);
         assert(methods != NULL);
         
         /* create 2d array to store bitpacked codewords */
-        int width = methods->width(uarray2) / BLOCKSIZE;
-        int height = methods->height(uarray2) / BLOCKSIZE;
+        int width = planes->width / BLOCKSIZE;
+        int height = planes->height / BLOCKSIZE;
         A2Methods_UArray2 wordsUArray2 = methods->new(width, height, 
                                             sizeof(uint32_t));
-        
-        /* put the 2d array in closure struct to be updated in apply func */
-        struct averagesClosure *averagesCl = malloc(sizeof(*averagesCl));
-        assert(averagesCl != NULL);
-        averagesCl->closureUArray2 = wordsUArray2;
-        averagesCl->methods = methods;
-
-        /* map through component video uarray2 and convert blocks to codewords 
-           and store them in the 2d array created above */
-        methods->map_default(uarray2, calculateAndPackWords, averagesCl);
-
-        /* free memory allocated for closure struct and passed-in uarray2 */
-        free(averagesCl);
-        methods->free(&uarray2);
+
+        struct wordRows rows = { planes, methods, wordsUArray2 };
+        SharedScheduler_bands(height, packWordRows, &rows);
         
         return wordsUArray2;
 }
 
-/********** calculateAndPackWords ********
+/********** packWordRows ********
  *
- * Description: An apply function to turn an index in uarray2 from CV to a 
- *              packed 32-bit codeword
+ * Description: Packs a band of rows of blocks of the planes into rows of
+ *              codewords, straight into the uarray2 when its rows are 
+ *              contiguous
  *
  * Input Parameters:
- *      int col:                        the current col in the uarray2
- *      int row:                        the current row in the uarray2
- *      A2Methods_UArray2 uarray2:      the uarray we are applying on
- *      void *elem:                     the element at this index (unused)
- *      void *cl:                       the closure variable for apply
+ *      unsigned first: the first row of codewords in the band
+ *      unsigned last:  the row after the band
+ *      void *cl:       the struct wordRows
+ *
+ * Ouput:
+ *      None
+ * 
+ * Notes:
+ *      Will CRE if cl is null or memory allocation for a row fails
+ *      Only rows that are not contiguous are packed into a row buffer 
+ *      and copied
+ *      
+ ************************/
+void packWordRows(unsigned first, unsigned last, void *cl)
+{
+        assert(cl != NULL);
+        struct wordRows *rows = cl;
+        int width = rows->methods->width(rows->words);
+        uint32_t *buffer = NULL;
+
+        for (unsigned row = first; row < last; row++) {
+                uint32_t *words = A2Methods_row(rows->methods, rows->words, 
+                                                row);
+                if (words == NULL && buffer == NULL) {
+                        buffer = malloc((width + 1) * sizeof(*buffer));
+                        assert(buffer != NULL);
+                }
+                packBlockRow(rows->planes, row * BLOCKSIZE, width, 
+                             words != NULL ? words : buffer);
+                if (words == NULL) {
+                        A2Methods_setRow(rows->methods, rows->words, row, 
+                                         buffer);
+                }
+        }
+
+        free(buffer);
+}
+
+/********** packBlockRow ********
+ *
+ * Description: Packs a row of 2x2 blocks of the planes into codewords, 
+ *              quantizing a batch of blocks at a time with the block 
+ *              kernels
+ *
+ * Input Parameters:
+ *      CvPlanes_T planes: the planes holding the blocks
+ *      unsigned row:      the top row of pixels of the blocks
+ *      unsigned count:    the number of blocks, starting at column 0
+ *      uint32_t *words:   where the count codewords go
  *
  * Ouput:
  *      None
  *
  * Expects
- *      uarray2 to not be null
- *      closure to not be null
+ *      planes and words to not be null
+ *      the blocks to lie inside the planes
  * Notes:
- *      Will CRE if uarray2 is null
- *      Will CRE if closure is null
+ *      Will CRE if planes or words is null
+ *      Blocks the kernels leave over are packed by packPlanesBlock, which
+ *      the kernels match exactly, so the codewords do not depend on the
+ *      CPU
+ *      The word kernels check a whole batch for overflow at once; a batch
+ *      that overflows is packed again with bitpack, which raises
+ *      Bitpack_Overflow for its first bad field
  *      
  ************************/
-void calculateAndPackWords(int col, int row, A2Methods_UArray2 uarray2, 
-                           void *elem, void *cl)
+void packBlockRow(CvPlanes_T planes, unsigned row, unsigned count, 
+                  uint32_t *words)
 {
-        (void) elem;
-        assert(uarray2 != NULL);
-        assert(cl != NULL);
-        
-        /* check that we are on the top left cell of a 2x2 block */
-        if (!(col % BLOCKSIZE == 0) || !(row % BLOCKSIZE == 0)) {
-                return;
+        assert(planes != NULL);
+        assert(words != NULL);
+
+        struct quantizedBlocks blocks;
+
+        for (unsigned first = 0; first < count; first += BLOCK_BATCH) {
+                unsigned batch = count - first;
+                if (batch > BLOCK_BATCH) {
+                        batch = BLOCK_BATCH;
+                }
+
+                unsigned done = BlockKernels_quantize(planes, 
+                                                      first * BLOCKSIZE, row,
+                                                      batch, &blocks);
+                struct wordFields *fields = &blocks.fields;
+                for (unsigned i = 0; i < done; i++) {
+                        fields->pb[i] = 
+                                Arith40_index_of_chroma(blocks.pbAverage[i]);
+                        fields->pr[i] = 
+                                Arith40_index_of_chroma(blocks.prAverage[i]);
+                }
+
+                /* pack the quantized blocks all at once */
+                if (!WordKernels_pack(fields, done, &words[first])) {
+                        for (unsigned i = 0; i < done; i++) {
+                                words[first + i] = bitpack(fields->a[i], 
+                                        fields->b[i], fields->c[i], 
+                                        fields->d[i], fields->pb[i], 
+                                        fields->pr[i]);
+                        }
+                }
+                for (unsigned i = done; i < batch; i++) {
+                        words[first + i] = packPlanesBlock(planes, 
+                                                (first + i) * BLOCKSIZE, row);
+                }
         }
+}
 
-        struct averagesClosure *avgClosure = cl;
-        struct componentVideo *cell1, *cell2, *cell3, *cell4;
+/********** packPlanesBlock ********
+ *
+ * Description: Converts the component video values of one 2x2 block of 
+ *              the planes into a bitpacked 32-bit codeword
+ *
+ * Input Parameters:
+ *      CvPlanes_T planes: the planes holding the block
+ *      unsigned col, row: the top left pixel of the block
+ *
+ * Ouput:
+ *      The 32-bit codeword holding a, b, c, d, Pb avg, and Pr avg
+ *
+ * Expects
+ *      planes to not be null
+ *      the block to lie inside the planes
+ * Notes:
+ *      Will CRE if planes is null
+ *      The scalar reference for the block kernels, and what packBlockRow
+ *      uses for the blocks they leave over
+ *      
+ ************************/
+uint32_t packPlanesBlock(CvPlanes_T planes, unsigned col, unsigned row)
+{
+        assert(planes != NULL);
+
+        size_t top = CvPlanes_index(planes, col, row);
+        size_t bottom = top + planes->stride;
+        struct blockAverages averagesStruct = { 0, 0, 0, 0, 0, 0 };
 
-        /* Get all four indices in the block */
-        cell1 = avgClosure->methods->at(uarray2, col, row);
-        cell2 = avgClosure->methods->at(uarray2, col + 1, row);
-        cell3 = avgClosure->methods->at(uarray2, col, row + 1);
-        cell4 = avgClosure->methods->at(uarray2, col + 1, row + 1);
-        
-        struct blockAverages *averagesStruct = calloc(1, 
-                                                      sizeof(*averagesStruct));
-        
         /* average pb and pr values of the block and store them in struct */
-        findAverageChroma(cell1, cell2, cell3, cell4, averagesStruct);
-        
+        averagesStruct.pb = Arith40_index_of_chroma(averageOfFour(
+                                planes->Pb[top], planes->Pb[top + 1],
+                                planes->Pb[bottom], planes->Pb[bottom + 1]));
+        averagesStruct.pr = Arith40_index_of_chroma(averageOfFour(
+                                planes->Pr[top], planes->Pr[top + 1],
+                                planes->Pr[bottom], planes->Pr[bottom + 1]));
+
         /* Use DCT to get a, b, c, and d from the block's Y values and 
            store them in struct*/
-        discreteCosineTransform(cell1->Y, cell2->Y, cell3->Y, cell4->Y, 
-                                averagesStruct);
-
-        /* get the spot in the words uarray2 to store the bitpacked codeword */
-        int arrayWordCol = col / 2;
-        int arrayWordRow = row / 2;
-        uint32_t *arrayWord = avgClosure->methods->at
-                              (avgClosure->closureUArray2, 
-                               arrayWordCol, arrayWordRow);
+        discreteCosineTransform(planes->Y[top], planes->Y[top + 1], 
+                                planes->Y[bottom], planes->Y[bottom + 1], 
+                                &averagesStruct);
 
         /* bitpack all "average" values from the block into a codeword */   
-        uint32_t word = bitpack(averagesStruct->a, averagesStruct->b, 
-                                averagesStruct->c, averagesStruct->d, 
-                                averagesStruct->pb, averagesStruct->pr);
-        
-        *arrayWord = word;
-
-        free(averagesStruct);
+        return bitpack(averagesStruct.a, averagesStruct.b, 
+                       averagesStruct.c, averagesStruct.d, 
+                       averagesStruct.pb, averagesStruct.pr);
 }
 
-/********** findAverageChroma ********
+/********** averageOfFour ********
  *
- * Description: To average the chroma values of a 2x2 block and store
- *              them in the given averagesStruct
+ * Description: To average the four values of one 2x2 block
  *
  * Input Parameters:
- *      struct componentVideo *cell1, *cell2, *cell3, *cell4: pointers to 
- *             the four cells in a 2x2 block
- *      struct blockAverages *averagesStruct: the struct to store the averages
- *                                            of the four cells in
+ *      float value1, value2, value3, value4: the top left, top right, 
+ *             bottom left, and bottom right values of the block
  *
  * Ouput:
- *      None
+ *      The average of the four values
  *
  * Expects
- *      NONE of the cells to be null (cell1, cell2, cell3, cell4)
- *      averagesStruct to not be null
+ *      none
  * Notes:
- *      Will CRE if ANY of the cells are null (cell1, cell2, cell3, cell4)
- *      Will CRE if averagesStruct is null
+ *      none
  *      
  ************************/
-void findAverageChroma(struct componentVideo *cell1, 
-                       struct componentVideo *cell2, 
-                       struct componentVideo *cell3, 
-                       struct componentVideo *cell4, 
-                       struct blockAverages *averagesStruct) 
+float averageOfFour(float value1, float value2, float value3, float value4)
 {
-        assert(averagesStruct != NULL);
-        assert(cell1 != NULL);
-        assert(cell2 != NULL);
-        assert(cell3 != NULL);
-        assert(cell4 != NULL);
-
-        /* average Pb values in block */
-        float pbSum = 0;
-        pbSum += cell1->Pb;
-        pbSum += cell2->Pb;
-        pbSum += cell3->Pb;
-        pbSum += cell4->Pb;
-        float pbAverage = pbSum / 4;
-        
-        /* average Pr values in block */
-        float prSum = 0;
-        prSum += cell1->Pr;
-        prSum += cell2->Pr;
-        prSum += cell3->Pr;
-        prSum += cell4->Pr;
-        float prAverage = prSum / 4;
-
-        /* use provided function to convert the averages to unsigned ints */
-        averagesStruct->pb = Arith40_index_of_chroma(pbAverage);
-        averagesStruct->pr = Arith40_index_of_chroma(prAverage);
+        float sum = 0;
+        sum += value1;
+        sum += value2;
+        sum += value3;
+        sum += value4;
+        return sum / 4;
 }
 
 /********** discreteCosineTransform ********
@@ -335,149 +383,149 @@ float capOrNoCapDCT(float coefficient)
 /********** wordsToBlocks ********
  *
  * Description: Transforms a uarray2 of 32-bit words into component video 
- *              blocks
+ *              planes
  *
  * Input Parameters:
- *      A2Methods_UArray2 uarray2: the uarray2 of pixels
+ *      A2Methods_UArray2 uarray2: the uarray2 of codewords
  *      A2Methods_T methods: the type of methods that uarray2 uses
+ *      CodecArena_T arena: the arena holding the planes
  *
  * Ouput:
- *      A new uarray2 which contains component video blocks
+ *      CvPlanes_T holding the Y, Pb and Pr planes of the image, which 
+ *      belong to the arena
  * 
  * Expects:
  *      uarray2 to not be null
  *      methods to not be null
+ *      arena to not be null
  * Notes:
- *      Expects uarray2 and methods to not be NULL, otherwise will CRE
+ *      Expects uarray2, methods and arena to not be NULL, otherwise will CRE
  *      May CRE if memory allocation fails
+ *      Unpacks bands of rows of codewords at once on the shared scheduler
  *      Frees memory allocated for uarray2
  *      
  ************************/
-A2Methods_UArray2 wordsToBlocks(A2Methods_UArray2 uarray2, A2Methods_T methods)
+CvPlanes_T wordsToBlocks(A2Methods_UArray2 uarray2, A2Methods_T methods,
+                         CodecArena_T arena)
 {
         assert(uarray2 != NULL);
         assert(methods != NULL);
+        assert(arena != NULL);
         
-        /* create 2d array to store unpacked component video pixels */
-        int width = methods->width(uarray2) * BLOCKSIZE;
-        int height = methods->height(uarray2) * BLOCKSIZE;
-        A2Methods_UArray2 cvUArray2 = methods->new(width, height, 
-                                            sizeof(struct componentVideo));
-        
-        /* put the 2d array in closure struct to be updated in apply func */
-        struct averagesClosure *averagesCl = malloc(sizeof(*averagesCl));
-        assert(averagesCl != NULL);
-        averagesCl->closureUArray2 = cvUArray2;
-        averagesCl->methods = methods;
-
-        /* map through the uarray2 with words and convert them to blocks
-           of component video pixels, storing them in 2d array created above */
-        methods->map_default(cvUArray2, populateCv, methods);
-        methods->map_default(uarray2, unpackAndCalculateCv, averagesCl);
-        
-        /* free memory allocated for closure struct and passed-in uarray2 */
-        free(averagesCl);
+        /* create the planes to store unpacked component video pixels */
+        int width = methods->width(uarray2);
+        int height = methods->height(uarray2);
+        CvPlanes_T planes = CodecArena_planes(arena, width * BLOCKSIZE, 
+                                              height * BLOCKSIZE);
+        struct wordRows rows = { planes, methods, uarray2 };
+        SharedScheduler_bands(height, unpackWordRows, &rows);
+
         methods->free(&uarray2); 
         
-        return cvUArray2;
+        return planes;
 }
 
-/********** unpackAndCalculateCv ********
+/********** unpackWordRows ********
  *
- * Description: An apply function to turn an index in uarray2 from a 32-bit 
- *              codeword to a component video struct
+ * Description: Unpacks a band of rows of codewords into their rows of 
+ *              blocks of the planes, straight from the uarray2 when its 
+ *              rows are contiguous
  *
  * Input Parameters:
- *      int col:                        the current col in the uarray2
- *      int row:                        the current row in the uarray2
- *      A2Methods_UArray2 uarray2:      the uarray we are applying on
- *      void *elem:                     the element at this index (unused)
- *      void *cl:                       the closure variable for apply
+ *      unsigned first: the first row of codewords in the band
+ *      unsigned last:  the row after the band
+ *      void *cl:       the struct wordRows
  *
  * Ouput:
  *      None
- *
- * Expects
- *      uarray2 to not be null
- *      closure to not be null
+ * 
  * Notes:
- *      Will CRE if uarray2 is null
- *      Will CRE if closure is null
+ *      Will CRE if cl is null or memory allocation for a row fails
+ *      Only rows that are not contiguous are copied into a row buffer 
+ *      first
  *      
  ************************/
-void unpackAndCalculateCv(int col, int row, A2Methods_UArray2 uarray2, 
-                          void *elem, void *cl)
+void unpackWordRows(unsigned first, unsigned last, void *cl)
 {
-        (void) uarray2;
-        assert(elem != NULL);
         assert(cl != NULL);
-        
-        uint32_t arrayWord = *(uint32_t *)elem;
-        struct averagesClosure *closure = cl;
-
-        /* Create structs to store unpacked scaled ints and block CV data */
-        struct blockAverages *averagesStruct = calloc(1, 
-                                               sizeof(*averagesStruct));
-        struct cvBlock *cvBlockStruct = calloc(1, sizeof(*cvBlockStruct));
-
-        struct componentVideo *cvStruct1, *cvStruct2,
-                              *cvStruct3, *cvStruct4;
-        
-        /* Get the four cells to unpack the word into */
-        int uarray2Col = col * BLOCKSIZE;
-        int uarray2Row = row * BLOCKSIZE;
-        cvStruct1 = closure->methods->at(closure->closureUArray2, 
-                                         uarray2Col, uarray2Row);
-        cvStruct2 = closure->methods->at(closure->closureUArray2, 
-                                         uarray2Col + 1, uarray2Row);
-        cvStruct3 = closure->methods->at(closure->closureUArray2, 
-                                         uarray2Col, uarray2Row + 1);
-        cvStruct4 = closure->methods->at(closure->closureUArray2, 
-                                         uarray2Col + 1, uarray2Row + 1);
-        
-        /* Unpack the codeword into a, b, c, d, pb, and pr */
-        unpackAverages(averagesStruct, arrayWord);
-
-        /* Turn the scaled integer values into data about a CV block */
-        convertAverages(averagesStruct, cvBlockStruct);
-
-        /* Update the individual CV cells with the block data */
-        setCv(cvBlockStruct, cvStruct1, cvStruct2, cvStruct3, cvStruct4);
+        struct wordRows *rows = cl;
+        int width = rows->methods->width(rows->words);
+        uint32_t *buffer = NULL;
+
+        for (unsigned row = first; row < last; row++) {
+                uint32_t *words = A2Methods_row(rows->methods, rows->words, 
+                                                row);
+                if (words == NULL) {
+                        if (buffer == NULL) {
+                                buffer = malloc((width + 1) * 
+                                                sizeof(*buffer));
+                                assert(buffer != NULL);
+                        }
+                        A2Methods_getRow(rows->methods, rows->words, row, 
+                                         buffer);
+                        words = buffer;
+                }
+                unpackBlockRow(words, width, rows->planes, row * BLOCKSIZE);
+        }
 
-        free(averagesStruct);
-        free(cvBlockStruct);
+        free(buffer);
 }
 
-/********** unpackAverages ********
+/********** unpackBlockRow ********
  *
- * Description: To unpack the parts of the codeword into coefficients in
- *              an averagesStruct
+ * Description: Unpacks a row of codewords into their 2x2 blocks of the 
+ *              planes, a batch of words at a time with the word kernels
  *
  * Input Parameters:
- *      struct blockAverages *averagesStruct: the averagesStruct to store 
- *                                            the packed values into
- *      uint32_t arrayWord: the word we are unpacking
+ *      const uint32_t *words: the codewords
+ *      unsigned count:        the number of codewords
+ *      CvPlanes_T planes:     the planes to fill in
+ *      unsigned row:          the top row of pixels of the blocks, which
+ *                             start at column 0
  *
  * Ouput:
  *      None
  *
  * Expects
- *      averagesStruct to not be null
+ *      words and planes to not be null
+ *      the blocks to lie inside the planes
  * Notes:
- *      Will CRE if averagesStruct is null
+ *      Will CRE if words or planes is null
+ *      Shared by wordsToBlocks and the fused decoder so that both produce
+ *      the same pixels
  *      
  ************************/
-void unpackAverages(struct blockAverages *averagesStruct, uint32_t arrayWord)
+void unpackBlockRow(const uint32_t *words, unsigned count, CvPlanes_T planes,
+                    unsigned row)
 {
-        assert(averagesStruct != NULL);
-
-        /* use the packOrUnpack functions to get individual values from word */
-        averagesStruct->a = unpackUnsigned(arrayWord, "a");
-        averagesStruct->b = unpackSigned(arrayWord, "b");
-        averagesStruct->c = unpackSigned(arrayWord, "c");
-        averagesStruct->d = unpackSigned(arrayWord, "d");
-        averagesStruct->pb = unpackUnsigned(arrayWord, "pb");
-        averagesStruct->pr = unpackUnsigned(arrayWord, "pr");
+        assert(words != NULL);
+        assert(planes != NULL);
+
+        struct wordFields fields;
+
+        for (unsigned first = 0; first < count; first += WORD_BATCH) {
+                unsigned batch = count - first;
+                if (batch > WORD_BATCH) {
+                        batch = WORD_BATCH;
+                }
+
+                /* Unpack the batch into a, b, c, d, pb, and pr */
+                WordKernels_unpack(&words[first], batch, &fields);
+
+                for (unsigned i = 0; i < batch; i++) {
+                        struct blockAverages averagesStruct = { 
+                                fields.a[i], fields.b[i], fields.c[i], 
+                                fields.d[i], fields.pb[i], fields.pr[i] 
+                        };
+                        struct cvBlock cvBlockStruct = { 0, 0, 0, 0, 0, 0 };
+
+                        /* Turn the scaled integer values into data about a
+                           CV block and update its values in each plane */
+                        convertAverages(&averagesStruct, &cvBlockStruct);
+                        setPlanes(&cvBlockStruct, planes, 
+                                  (first + i) * BLOCKSIZE, row);
+                }
+        }
 }
 
 /********** convertAverages ********
@@ -533,48 +581,48 @@ void convertAverages(struct blockAverages *averagesStruct,
         cvBlockStruct->pr = pr;
 }
 
-/********** setCv ********
+/********** setPlanes ********
  *
- * Description: To set the CV values for all of the blocks a 2x2 block
+ * Description: To set the CV values of a 2x2 block in the planes
  *
  * Input Parameters:
  *      struct cvBlock *cvBlockStruct: the struct containing all the values
- *                                     for the blocks
- *      struct componentVideo *cvStruct1, *cvStruct2, *cvStruct3, *cvStruct4:
- *              The component video struct for each 2x2 blcok
+ *                                     for the block
+ *      CvPlanes_T planes: the planes to store the values in
+ *      unsigned col, row: the top left pixel of the block
  *
  * Ouput:
  *      None
  *
  * Expects
- *      averagesStruct to not be null
+ *      cvBlockStruct to not be null
+ *      planes to not be null
  * Notes:
- *      Will CRE if averagesStruct is null
+ *      Will CRE if cvBlockStruct or planes is null
  *      
  ************************/
-void setCv(struct cvBlock *cvBlockStruct, 
-           struct componentVideo *cvStruct1, struct componentVideo *cvStruct2, 
-           struct componentVideo *cvStruct3, struct componentVideo *cvStruct4)
+void setPlanes(struct cvBlock *cvBlockStruct, CvPlanes_T planes, 
+               unsigned col, unsigned row)
 {
         assert(cvBlockStruct != NULL);
-        assert(cvStruct1 != NULL);
-        assert(cvStruct2 != NULL);
-        assert(cvStruct3 != NULL);
-        assert(cvStruct4 != NULL);
-
-        /* Update the luma and chroma values for all four CV pixels */
-        cvStruct1->Y = cvBlockStruct->y1;
-        cvStruct2->Y = cvBlockStruct->y2;
-        cvStruct3->Y = cvBlockStruct->y3;
-        cvStruct4->Y = cvBlockStruct->y4;
-
-        cvStruct1->Pb = cvBlockStruct->pb;
-        cvStruct2->Pb = cvBlockStruct->pb;
-        cvStruct3->Pb = cvBlockStruct->pb;
-        cvStruct4->Pb = cvBlockStruct->pb;
-
-        cvStruct1->Pr = cvBlockStruct->pr;
-        cvStruct2->Pr = cvBlockStruct->pr;
-        cvStruct3->Pr = cvBlockStruct->pr;
-        cvStruct4->Pr = cvBlockStruct->pr;
+        assert(planes != NULL);
+
+        size_t top = CvPlanes_index(planes, col, row);
+        size_t bottom = top + planes->stride;
+
+        /* Update the luma of all four pixels, then the chroma of both rows*/
+        planes->Y[top] = cvBlockStruct->y1;
+        planes->Y[top + 1] = cvBlockStruct->y2;
+        planes->Y[bottom] = cvBlockStruct->y3;
+        planes->Y[bottom + 1] = cvBlockStruct->y4;
+
+        planes->Pb[top] = cvBlockStruct->pb;
+        planes->Pb[top + 1] = cvBlockStruct->pb;
+        planes->Pb[bottom] = cvBlockStruct->pb;
+        planes->Pb[bottom + 1] = cvBlockStruct->pb;
+
+        planes->Pr[top] = cvBlockStruct->pr;
+        planes->Pr[top + 1] = cvBlockStruct->pr;
+        planes->Pr[bottom] = cvBlockStruct->pr;
+        planes->Pr[bottom + 1] = cvBlockStruct->pr;
 }
@@ -5,23 +5,31 @@
  *
  *      This file contains the interface for conversions between component 
  *      video pixels and bitpacked codewords. Specifically, it turns 2x2 blocks
- *      of component video pixels into codewords, exporting a function for 
- *      conversion in each direction.
+ *      of component video planes into codewords, exporting a function for 
+ *      conversion in each direction, the same conversions for a row of
+ *      blocks, and packing for a single block.
  *  
  */
 #ifndef WORD_CONVERSIONS
 #define WORD_CONVERSIONS
 
+#include <stdint.h>
 #include "a2blocked.h"
 #include "a2plain.h"
+#include "cvPlanes.h"
+#include "codecArena.h"
 
 /* Compression */
-A2Methods_UArray2 blocksToWords(A2Methods_UArray2 uarray2, 
-                                A2Methods_T methods);
+A2Methods_UArray2 blocksToWords(CvPlanes_T planes, A2Methods_T methods);
+void packBlockRow(CvPlanes_T planes, unsigned row, unsigned count, 
+                  uint32_t *words);
+uint32_t packPlanesBlock(CvPlanes_T planes, unsigned col, unsigned row);
 
 /* Decompression */
-A2Methods_UArray2 wordsToBlocks(A2Methods_UArray2 uarray2, 
-                                A2Methods_T methods);
+CvPlanes_T wordsToBlocks(A2Methods_UArray2 uarray2, A2Methods_T methods,
+                         CodecArena_T arena);
+void unpackBlockRow(const uint32_t *words, unsigned count, CvPlanes_T planes,
+                    unsigned row);
                                   
 #undef WORD_CONVERSIONS
 #endif
\ No newline at end of file
@@ -0,0 +1,431 @@
+/*
+ *      wordKernels.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation of the word kernels. The
+ *      plain C kernels are generated from the codeword schema. For the
+ *      vector kernels every field of the schema is described once per call
+ *      by its width, lsb and signedness, and a kernel packs a vector of
+ *      words by range checking each field against its limits, masking it
+ *      to its width, shifting it to its lsb and or-ing it in. The
+ *      out-of-range lanes of every field are or-ed into one mask, tested
+ *      once when the run is done. Unpacking shifts and masks unsigned
+ *      fields, and shifts signed fields to the top of the word and
+ *      arithmetically back down to sign-extend them, as Bitpack_gets does.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "assert.h"
+
+#include "simdLevel.h"
+#include "wordKernels.h"
+
+#ifdef SIMD_X86
+#include <immintrin.h>
+#endif
+
+#define FIELD_COUNT CODEWORD_FIELD_COUNT
+
+/* One field of the codeword and the run of values it holds */
+struct field {
+        int32_t *values;   /* the field's array in a struct wordFields */
+        int32_t min, max;  /* the range a value must lie in to fit */
+        uint32_t mask;     /* width low bits set */
+        unsigned lsb;
+        unsigned up, down; /* shifts that sign-extend a signed field */
+        bool isSigned;
+};
+
+/********** describe ********
+ *
+ *  Describes one field of the codeword
+ *
+ * Parameters:
+ *      int32_t *values:  the field's values
+ *      unsigned width:   the field's width in bits, less than 32
+ *      unsigned lsb:     the field's least significant bit
+ *      bool isSigned:    whether the field holds two's complement values
+ *
+ * Return:
+ *      The field, with its limits, mask and shifts worked out
+ *
+ ************************/
+static struct field describe(int32_t *values, unsigned width, unsigned lsb,
+                             bool isSigned)
+{
+        struct field field;
+        field.values = values;
+        field.mask = ((uint32_t)1 << width) - 1;
+        field.lsb = lsb;
+        field.up = 32 - lsb - width;
+        field.down = 32 - width;
+        field.isSigned = isSigned;
+        if (isSigned) {
+                field.min = -((int32_t)1 << (width - 1));
+                field.max = ((int32_t)1 << (width - 1)) - 1;
+        } else {
+                field.min = 0;
+                field.max = field.mask;
+        }
+        return field;
+}
+
+/* fills layout with the fields of the codeword schema, in order */
+static void describeFields(struct wordFields *fields,
+                           struct field layout[FIELD_COUNT])
+{
+        unsigned f = 0;
+#define DESCRIBE_FIELD(name, width, lsb, kind) \
+        layout[f++] = describe(fields->name, width, lsb, \
+                               CODEWORD_IS_SIGNED_##kind);
+        CODEWORD_FIELDS(DESCRIBE_FIELD)
+#undef DESCRIBE_FIELD
+}
+
+/****************************************************************
+*                                                               *
+*                         Scalar Kernels                        *
+*                                                               *
+*****************************************************************/
+
+/* packs words first up to count, noting any field that does not fit */
+static void packScalar(const struct wordFields *fields, unsigned first,
+                       unsigned count, uint32_t *words, bool *overflow)
+{
+        for (unsigned i = first; i < count; i++) {
+                uint32_t word = 0;
+#define PACK_FIELD(name, width, lsb, kind) \
+                if (!Codeword_fits_##name(fields->name[i])) { \
+                        *overflow = true; \
+                } \
+                word = Codeword_set_##name(word, fields->name[i]);
+                CODEWORD_FIELDS(PACK_FIELD)
+#undef PACK_FIELD
+                words[i] = word;
+        }
+}
+
+/* unpacks words first up to count */
+static void unpackScalar(struct wordFields *fields, unsigned first,
+                         unsigned count, const uint32_t *words)
+{
+        for (unsigned i = first; i < count; i++) {
+#define UNPACK_FIELD(name, width, lsb, kind) \
+                fields->name[i] = Codeword_##name(words[i]);
+                CODEWORD_FIELDS(UNPACK_FIELD)
+#undef UNPACK_FIELD
+        }
+}
+
+#ifdef SIMD_X86
+
+/****************************************************************
+*                                                               *
+*                         SSE4.1 Kernels                        *
+*                                                               *
+*****************************************************************/
+
+SIMD_TARGET_SSE41
+static unsigned packSse(const struct field *layout, unsigned count,
+                        uint32_t *words, bool *overflow)
+{
+        __m128i bad = _mm_setzero_si128();
+        unsigned i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+                __m128i word = _mm_setzero_si128();
+                for (unsigned f = 0; f < FIELD_COUNT; f++) {
+                        const struct field *field = &layout[f];
+                        __m128i value = _mm_loadu_si128(
+                                (const __m128i *)(field->values + i));
+                        bad = _mm_or_si128(bad, _mm_or_si128(
+                                _mm_cmplt_epi32(value,
+                                                _mm_set1_epi32(field->min)),
+                                _mm_cmpgt_epi32(value,
+                                                _mm_set1_epi32(field->max))));
+                        value = _mm_and_si128(value,
+                                              _mm_set1_epi32(field->mask));
+                        word = _mm_or_si128(word, _mm_sll_epi32(value,
+                                        _mm_cvtsi32_si128(field->lsb)));
+                }
+                _mm_storeu_si128((__m128i *)(words + i), word);
+        }
+
+        if (!_mm_testz_si128(bad, bad)) {
+                *overflow = true;
+        }
+        return i;
+}
+
+SIMD_TARGET_SSE41
+static unsigned unpackSse(const struct field *layout, unsigned count,
+                          const uint32_t *words)
+{
+        unsigned i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+                __m128i word = _mm_loadu_si128((const __m128i *)(words + i));
+                for (unsigned f = 0; f < FIELD_COUNT; f++) {
+                        const struct field *field = &layout[f];
+                        __m128i value;
+                        if (field->isSigned) {
+                                value = _mm_sra_epi32(_mm_sll_epi32(word,
+                                                _mm_cvtsi32_si128(field->up)),
+                                        _mm_cvtsi32_si128(field->down));
+                        } else {
+                                value = _mm_and_si128(_mm_srl_epi32(word,
+                                                _mm_cvtsi32_si128(field->lsb)),
+                                        _mm_set1_epi32(field->mask));
+                        }
+                        _mm_storeu_si128((__m128i *)(field->values + i),
+                                         value);
+                }
+        }
+
+        return i;
+}
+
+/****************************************************************
+*                                                               *
+*                          AVX2 Kernels                         *
+*                                                               *
+*****************************************************************/
+
+SIMD_TARGET_AVX2
+static unsigned packAvx2(const struct field *layout, unsigned count,
+                         uint32_t *words, bool *overflow)
+{
+        __m256i bad = _mm256_setzero_si256();
+        unsigned i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+                __m256i word = _mm256_setzero_si256();
+                for (unsigned f = 0; f < FIELD_COUNT; f++) {
+                        const struct field *field = &layout[f];
+                        __m256i value = _mm256_loadu_si256(
+                                (const __m256i *)(field->values + i));
+                        bad = _mm256_or_si256(bad, _mm256_or_si256(
+                                _mm256_cmpgt_epi32(
+                                        _mm256_set1_epi32(field->min), value),
+                                _mm256_cmpgt_epi32(value,
+                                        _mm256_set1_epi32(field->max))));
+                        value = _mm256_and_si256(value,
+                                        _mm256_set1_epi32(field->mask));
+                        word = _mm256_or_si256(word, _mm256_sll_epi32(value,
+                                        _mm_cvtsi32_si128(field->lsb)));
+                }
+                _mm256_storeu_si256((__m256i *)(words + i), word);
+        }
+
+        if (!_mm256_testz_si256(bad, bad)) {
+                *overflow = true;
+        }
+        return i;
+}
+
+SIMD_TARGET_AVX2
+static unsigned unpackAvx2(const struct field *layout, unsigned count,
+                           const uint32_t *words)
+{
+        unsigned i = 0;
+
+        for (; i + 8 <= count; i += 8) {
+                __m256i word = _mm256_loadu_si256(
+                        (const __m256i *)(words + i));
+                for (unsigned f = 0; f < FIELD_COUNT; f++) {
+                        const struct field *field = &layout[f];
+                        __m256i value;
+                        if (field->isSigned) {
+                                value = _mm256_sra_epi32(_mm256_sll_epi32(
+                                        word, _mm_cvtsi32_si128(field->up)),
+                                        _mm_cvtsi32_si128(field->down));
+                        } else {
+                                value = _mm256_and_si256(_mm256_srl_epi32(
+                                        word, _mm_cvtsi32_si128(field->lsb)),
+                                        _mm256_set1_epi32(field->mask));
+                        }
+                        _mm256_storeu_si256((__m256i *)(field->values + i),
+                                            value);
+                }
+        }
+
+        return i;
+}
+
+/****************************************************************
+*                                                               *
+*                        AVX-512 Kernels                        *
+*                                                               *
+*****************************************************************/
+
+SIMD_TARGET_AVX512
+static unsigned packAvx512(const struct field *layout, unsigned count,
+                           uint32_t *words, bool *overflow)
+{
+        __mmask16 bad = 0;
+        unsigned i = 0;
+
+        for (; i + 16 <= count; i += 16) {
+                __m512i word = _mm512_setzero_si512();
+                for (unsigned f = 0; f < FIELD_COUNT; f++) {
+                        const struct field *field = &layout[f];
+                        __m512i value = _mm512_loadu_si512(field->values + i);
+                        bad |= _mm512_cmplt_epi32_mask(value,
+                                        _mm512_set1_epi32(field->min));
+                        bad |= _mm512_cmpgt_epi32_mask(value,
+                                        _mm512_set1_epi32(field->max));
+                        value = _mm512_and_si512(value,
+                                        _mm512_set1_epi32(field->mask));
+                        word = _mm512_or_si512(word, _mm512_sll_epi32(value,
+                                        _mm_cvtsi32_si128(field->lsb)));
+                }
+                _mm512_storeu_si512(words + i, word);
+        }
+
+        if (bad != 0) {
+                *overflow = true;
+        }
+        return i;
+}
+
+SIMD_TARGET_AVX512
+static unsigned unpackAvx512(const struct field *layout, unsigned count,
+                             const uint32_t *words)
+{
+        unsigned i = 0;
+
+        for (; i + 16 <= count; i += 16) {
+                __m512i word = _mm512_loadu_si512(words + i);
+                for (unsigned f = 0; f < FIELD_COUNT; f++) {
+                        const struct field *field = &layout[f];
+                        __m512i value;
+                        if (field->isSigned) {
+                                value = _mm512_sra_epi32(_mm512_sll_epi32(
+                                        word, _mm_cvtsi32_si128(field->up)),
+                                        _mm_cvtsi32_si128(field->down));
+                        } else {
+                                value = _mm512_and_si512(_mm512_srl_epi32(
+                                        word, _mm_cvtsi32_si128(field->lsb)),
+                                        _mm512_set1_epi32(field->mask));
+                        }
+                        _mm512_storeu_si512(field->values + i, value);
+                }
+        }
+
+        return i;
+}
+
+#endif
+
+/****************************************************************
+*                                                               *
+*                          Entry Points                         *
+*                                                               *
+*****************************************************************/
+
+/********** WordKernels_pack ********
+ *
+ *  Packs a run of fields into codewords with the widest kernel there is
+ *
+ * Parameters:
+ *      struct wordFields *fields: the fields of each codeword
+ *      unsigned count:            the number of codewords
+ *      uint32_t *words:           where the count codewords go
+ *
+ * Return:
+ *      true if every field fit in its width, otherwise false
+ *
+ * Expects
+ *      fields and words to not be null
+ *      count to be at most WORD_BATCH
+ *
+ * Notes:
+ *      Will CRE if fields or words is null or count is too large
+ *      Never raises Bitpack_Overflow: a caller that wants the exception
+ *      packs the run again with bitpack
+ *
+ ************************/
+bool WordKernels_pack(struct wordFields *fields, unsigned count,
+                      uint32_t *words)
+{
+        assert(fields != NULL);
+        assert(words != NULL);
+        assert(count <= WORD_BATCH);
+
+        struct field layout[FIELD_COUNT];
+        describeFields(fields, layout);
+        bool overflow = false;
+        unsigned done = 0;
+
+        switch (SimdLevel_get()) {
+#ifdef SIMD_X86
+        case SIMD_AVX512:
+                done = packAvx512(layout, count, words, &overflow);
+                break;
+        case SIMD_AVX2:
+                done = packAvx2(layout, count, words, &overflow);
+                break;
+        case SIMD_SSE41:
+                done = packSse(layout, count, words, &overflow);
+                break;
+#endif
+        default:
+                break;
+        }
+
+        packScalar(fields, done, count, words, &overflow);
+        return !overflow;
+}
+
+/********** WordKernels_unpack ********
+ *
+ *  Unpacks a run of codewords into their fields with the widest kernel
+ *  there is
+ *
+ * Parameters:
+ *      const uint32_t *words:     the count codewords to unpack
+ *      unsigned count:            the number of codewords
+ *      struct wordFields *fields: where the fields of each codeword go
+ *
+ * Return:
+ *      none
+ *
+ * Expects
+ *      words and fields to not be null
+ *      count to be at most WORD_BATCH
+ *
+ * Notes:
+ *      Will CRE if words or fields is null or count is too large
+ *
+ ************************/
+void WordKernels_unpack(const uint32_t *words, unsigned count,
+                        struct wordFields *fields)
+{
+        assert(words != NULL);
+        assert(fields != NULL);
+        assert(count <= WORD_BATCH);
+
+        struct field layout[FIELD_COUNT];
+        describeFields(fields, layout);
+        unsigned done = 0;
+
+        switch (SimdLevel_get()) {
+#ifdef SIMD_X86
+        case SIMD_AVX512:
+                done = unpackAvx512(layout, count, words);
+                break;
+        case SIMD_AVX2:
+                done = unpackAvx2(layout, count, words);
+                break;
+        case SIMD_SSE41:
+                done = unpackSse(layout, count, words);
+                break;
+#endif
+        default:
+                break;
+        }
+
+        unpackScalar(fields, done, count, words);
+}
@@ -0,0 +1,38 @@
+/*
+ *      wordKernels.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the word kernels, which pack
+ *      runs of a, b, c, d, pb and pr values into 32-bit codewords, or
+ *      unpack runs of codewords into their fields, several words at a
+ *      time, with the layout of the codeword schema. Packing checks every
+ *      field's range as it goes and reports an overflow once for the whole
+ *      run instead of raising Bitpack_Overflow for the first bad field.
+ */
+
+#ifndef WORD_KERNELS
+#define WORD_KERNELS
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "codeword.h"
+
+/* The most codewords packed or unpacked in one call */
+#define WORD_BATCH 64
+
+/* the fields of a run of codewords, one array per field of the codeword
+   schema, named after the field (a, b, c, d, pb and pr) */
+#define WORD_FIELD(name, width, lsb, kind) int32_t name[WORD_BATCH];
+struct wordFields {
+        CODEWORD_FIELDS(WORD_FIELD)
+};
+#undef WORD_FIELD
+
+/* returns false, leaving words unspecified, if any field does not fit */
+bool WordKernels_pack(struct wordFields *fields, unsigned count,
+                      uint32_t *words);
+void WordKernels_unpack(const uint32_t *words, unsigned count,
+                        struct wordFields *fields);
+
+#endif
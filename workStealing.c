@@ -0,0 +1,409 @@
+/*
+ *      workStealing.c
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the implementation for the Scheduler abstraction.
+ *      Each deque is a growable ring buffer with its own lock: the owner 
+ *      pushes and pops at the bottom and thieves take from the top. Idle 
+ *      workers sleep on a condition variable until a task is submitted.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "assert.h"
+
+#include "workStealing.h"
+
+/* The number of tasks a deque can hold before it first grows */
+static const unsigned INITIAL_DEQUE_SIZE = 64;
+
+/* A task is a function to run and the argument to run it on */
+struct task {
+        void (*run)(void *task);
+        void *arg;
+};
+
+/* A deque of tasks, stored in a ring buffer of capacity elements starting
+   at index top */
+struct deque {
+        pthread_mutex_t lock;
+        struct task *tasks;
+        unsigned capacity;
+        unsigned top;
+        unsigned length;
+};
+
+/* A worker thread and the deque it owns */
+struct worker {
+        pthread_t thread;
+        Scheduler_T scheduler;
+        unsigned index;
+        struct deque deque;
+};
+
+struct Scheduler_T {
+        unsigned count;          /* number of workers */
+        struct worker *workers;
+        pthread_key_t self;      /* the struct worker of the current thread */
+
+        pthread_mutex_t lock;    /* protects everything below */
+        pthread_cond_t workReady;
+        pthread_cond_t allDone;
+        unsigned queued;         /* tasks sitting in a deque */
+        unsigned pending;        /* tasks submitted but not finished */
+        unsigned nextWorker;     /* the deque for the next outside task */
+        bool stopping;
+};
+
+static void *workerLoop(void *vworker);
+static bool findTask(struct worker *worker, struct task *task);
+static void pushBottom(struct deque *deque, struct task task);
+static bool popBottom(struct deque *deque, struct task *task);
+static bool popTop(struct deque *deque, struct task *task);
+
+/********** Scheduler_new ********
+ *
+ *  Starts a scheduler with the given number of worker threads
+ *
+ * Parameters:
+ *      unsigned workers: the number of worker threads
+ *
+ * Return: 
+ *      A new Scheduler_T
+ *
+ * Expects
+ *      workers to be at least 1
+ * 
+ * Notes:
+ *      Will CRE if workers is 0
+ *      Will CRE if memory allocation or thread creation fails
+ *      The caller must free the scheduler with Scheduler_free
+ *      
+ ************************/
+Scheduler_T Scheduler_new(unsigned workers)
+{
+        assert(workers > 0);
+
+        Scheduler_T scheduler = malloc(sizeof(*scheduler));
+        assert(scheduler != NULL);
+        scheduler->count = workers;
+        scheduler->workers = malloc(workers * sizeof(struct worker));
+        assert(scheduler->workers != NULL);
+        int made = pthread_key_create(&scheduler->self, NULL);
+        assert(made == 0);
+
+        pthread_mutex_init(&scheduler->lock, NULL);
+        pthread_cond_init(&scheduler->workReady, NULL);
+        pthread_cond_init(&scheduler->allDone, NULL);
+        scheduler->queued = 0;
+        scheduler->pending = 0;
+        scheduler->nextWorker = 0;
+        scheduler->stopping = false;
+
+        for (unsigned i = 0; i < workers; i++) {
+                struct worker *worker = &scheduler->workers[i];
+                worker->scheduler = scheduler;
+                worker->index = i;
+                pthread_mutex_init(&worker->deque.lock, NULL);
+                worker->deque.tasks = malloc(INITIAL_DEQUE_SIZE * 
+                                             sizeof(struct task));
+                assert(worker->deque.tasks != NULL);
+                worker->deque.capacity = INITIAL_DEQUE_SIZE;
+                worker->deque.top = 0;
+                worker->deque.length = 0;
+        }
+        for (unsigned i = 0; i < workers; i++) {
+                made = pthread_create(&scheduler->workers[i].thread, NULL, 
+                                      workerLoop, &scheduler->workers[i]);
+                assert(made == 0);
+        }
+
+        return scheduler;
+}
+
+/********** Scheduler_free ********
+ *
+ *  Waits for every submitted task, stops the workers, and frees the 
+ *  scheduler
+ *
+ * Parameters:
+ *      Scheduler_T *scheduler: a pointer to the scheduler to free
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      scheduler and *scheduler to not be null
+ *      not to be called from inside a task
+ * 
+ * Notes:
+ *      Will CRE if scheduler or *scheduler is null
+ *      
+ ************************/
+void Scheduler_free(Scheduler_T *scheduler)
+{
+        assert(scheduler != NULL && *scheduler != NULL);
+        Scheduler_T s = *scheduler;
+
+        Scheduler_wait(s);
+        pthread_mutex_lock(&s->lock);
+        s->stopping = true;
+        pthread_cond_broadcast(&s->workReady);
+        pthread_mutex_unlock(&s->lock);
+
+        /* a worker may look in any deque until it exits, so join them all
+           before tearing the deques down */
+        for (unsigned i = 0; i < s->count; i++) {
+                pthread_join(s->workers[i].thread, NULL);
+        }
+        for (unsigned i = 0; i < s->count; i++) {
+                pthread_mutex_destroy(&s->workers[i].deque.lock);
+                free(s->workers[i].deque.tasks);
+        }
+        pthread_key_delete(s->self);
+        pthread_mutex_destroy(&s->lock);
+        pthread_cond_destroy(&s->workReady);
+        pthread_cond_destroy(&s->allDone);
+        free(s->workers);
+        free(s);
+        *scheduler = NULL;
+}
+
+/********** Scheduler_workers ********
+ *
+ *  Returns the number of worker threads in the scheduler
+ *
+ ************************/
+unsigned Scheduler_workers(Scheduler_T scheduler)
+{
+        assert(scheduler != NULL);
+        return scheduler->count;
+}
+
+/********** Scheduler_submit ********
+ *
+ *  Queues a task to be run by one of the workers
+ *
+ * Parameters:
+ *      Scheduler_T scheduler: the scheduler to run the task
+ *      void run(void *task):  the function to run
+ *      void *task:            the argument to pass to run
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      scheduler and run to not be null
+ * 
+ * Notes:
+ *      Will CRE if scheduler or run is null
+ *      Tasks submitted by a worker go on its own deque, so the work a task
+ *      splits off stays local unless another worker is idle
+ *      
+ ************************/
+void Scheduler_submit(Scheduler_T scheduler, void run(void *task), 
+                      void *task)
+{
+        assert(scheduler != NULL);
+        assert(run != NULL);
+        struct task newTask = { run, task };
+
+        struct worker *self = pthread_getspecific(scheduler->self);
+        pthread_mutex_lock(&scheduler->lock);
+        scheduler->pending++;
+        scheduler->queued++;
+        if (self == NULL || self->scheduler != scheduler) {
+                self = &scheduler->workers[scheduler->nextWorker];
+                scheduler->nextWorker = (scheduler->nextWorker + 1) % 
+                                        scheduler->count;
+        }
+        pthread_mutex_unlock(&scheduler->lock);
+
+        pushBottom(&self->deque, newTask);
+
+        pthread_mutex_lock(&scheduler->lock);
+        pthread_cond_signal(&scheduler->workReady);
+        pthread_mutex_unlock(&scheduler->lock);
+}
+
+/********** Scheduler_wait ********
+ *
+ *  Blocks until every task submitted so far, and every task those tasks
+ *  submitted, has finished
+ *
+ * Parameters:
+ *      Scheduler_T scheduler: the scheduler to wait on
+ *
+ * Return: 
+ *      none
+ *
+ * Expects
+ *      not to be called from inside a task
+ * 
+ ************************/
+void Scheduler_wait(Scheduler_T scheduler)
+{
+        assert(scheduler != NULL);
+        pthread_mutex_lock(&scheduler->lock);
+        while (scheduler->pending > 0) {
+                pthread_cond_wait(&scheduler->allDone, &scheduler->lock);
+        }
+        pthread_mutex_unlock(&scheduler->lock);
+}
+
+/********** workerLoop ********
+ *
+ *  The thread function of a worker: runs tasks from its own deque or 
+ *  stolen from others, and sleeps when there are none
+ *
+ * Parameters:
+ *      void *vworker: the struct worker this thread runs
+ *
+ * Return: 
+ *      NULL, once the scheduler is stopping and no tasks are left
+ *
+ ************************/
+static void *workerLoop(void *vworker)
+{
+        struct worker *worker = vworker;
+        Scheduler_T scheduler = worker->scheduler;
+        pthread_setspecific(scheduler->self, worker);
+
+        for (;;) {
+                struct task task;
+                if (findTask(worker, &task)) {
+                        pthread_mutex_lock(&scheduler->lock);
+                        scheduler->queued--;
+                        pthread_mutex_unlock(&scheduler->lock);
+
+                        task.run(task.arg);
+
+                        pthread_mutex_lock(&scheduler->lock);
+                        if (--scheduler->pending == 0) {
+                                pthread_cond_broadcast(&scheduler->allDone);
+                        }
+                        pthread_mutex_unlock(&scheduler->lock);
+                        continue;
+                }
+
+                /* A task that is counted as queued but was not found is
+                   still being pushed, so look again rather than sleep */
+                pthread_mutex_lock(&scheduler->lock);
+                while (scheduler->queued == 0 && !scheduler->stopping) {
+                        pthread_cond_wait(&scheduler->workReady, 
+                                          &scheduler->lock);
+                }
+                bool stop = scheduler->stopping && scheduler->queued == 0;
+                pthread_mutex_unlock(&scheduler->lock);
+                if (stop) {
+                        return NULL;
+                }
+        }
+}
+
+/********** findTask ********
+ *
+ *  Takes the newest task from the worker's own deque, or else the oldest
+ *  task from the first other worker that has one
+ *
+ * Parameters:
+ *      struct worker *worker: the worker looking for a task
+ *      struct task *task:     where to store the task found
+ *
+ * Return: 
+ *      true if a task was found
+ *
+ ************************/
+static bool findTask(struct worker *worker, struct task *task)
+{
+        if (popBottom(&worker->deque, task)) {
+                return true;
+        }
+
+        Scheduler_T scheduler = worker->scheduler;
+        for (unsigned i = 1; i < scheduler->count; i++) {
+                unsigned victim = (worker->index + i) % scheduler->count;
+                if (popTop(&scheduler->workers[victim].deque, task)) {
+                        return true;
+                }
+        }
+        return false;
+}
+
+/********** pushBottom ********
+ *
+ *  Adds a task to the bottom of a deque, doubling its capacity if it is 
+ *  full
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails
+ *
+ ************************/
+static void pushBottom(struct deque *deque, struct task task)
+{
+        pthread_mutex_lock(&deque->lock);
+        if (deque->length == deque->capacity) {
+                /* unroll the ring into a buffer twice the size */
+                struct task *tasks = malloc(2 * deque->capacity * 
+                                            sizeof(*tasks));
+                assert(tasks != NULL);
+                for (unsigned i = 0; i < deque->length; i++) {
+                        tasks[i] = deque->tasks[(deque->top + i) % 
+                                                deque->capacity];
+                }
+                free(deque->tasks);
+                deque->tasks = tasks;
+                deque->capacity *= 2;
+                deque->top = 0;
+        }
+        unsigned bottom = (deque->top + deque->length) % deque->capacity;
+        deque->tasks[bottom] = task;
+        deque->length++;
+        pthread_mutex_unlock(&deque->lock);
+}
+
+/********** popBottom ********
+ *
+ *  Removes the newest task from a deque, for its owner
+ *
+ * Return: 
+ *      true if the deque had a task
+ *
+ ************************/
+static bool popBottom(struct deque *deque, struct task *task)
+{
+        bool found = false;
+        pthread_mutex_lock(&deque->lock);
+        if (deque->length > 0) {
+                deque->length--;
+                *task = deque->tasks[(deque->top + deque->length) % 
+                                     deque->capacity];
+                found = true;
+        }
+        pthread_mutex_unlock(&deque->lock);
+        return found;
+}
+
+/********** popTop ********
+ *
+ *  Removes the oldest task from a deque, for a thief
+ *
+ * Return: 
+ *      true if the deque had a task
+ *
+ ************************/
+static bool popTop(struct deque *deque, struct task *task)
+{
+        bool found = false;
+        pthread_mutex_lock(&deque->lock);
+        if (deque->length > 0) {
+                *task = deque->tasks[deque->top];
+                deque->top = (deque->top + 1) % deque->capacity;
+                deque->length--;
+                found = true;
+        }
+        pthread_mutex_unlock(&deque->lock);
+        return found;
+}
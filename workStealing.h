@@ -0,0 +1,32 @@
+/*
+ *      workStealing.h
+ *      by Peter Morganelli and Shepard Rodgers, 10/16/26
+ *      arith assignment
+ *
+ *      This file contains the interface for the Scheduler abstraction, a 
+ *      pool of worker threads that each own a deque of tasks. A worker runs
+ *      the newest task in its own deque first, and when its deque is empty
+ *      it steals the oldest task from another worker, so a few large jobs
+ *      and many small ones keep every worker busy.
+ *
+ *      A task submitted from inside a running task goes on the submitting
+ *      worker's own deque; other tasks are dealt out to the workers in turn.
+ */
+
+#ifndef WORK_STEALING
+#define WORK_STEALING
+
+typedef struct Scheduler_T *Scheduler_T;
+
+Scheduler_T Scheduler_new(unsigned workers);
+/* waits for every submitted task to finish, then stops the workers */
+void Scheduler_free(Scheduler_T *scheduler);
+
+unsigned Scheduler_workers(Scheduler_T scheduler);
+
+void Scheduler_submit(Scheduler_T scheduler, void run(void *task), 
+                      void *task);
+/* blocks until every submitted task has finished */
+void Scheduler_wait(Scheduler_T scheduler);
+
+#endif